@@ -0,0 +1,1331 @@
+/**
+ * @file host_benchmark.cpp
+ * @brief HydrogenUI 主机端性能基准
+ *
+ * 在 Linux/macOS 主机上直接编译运行，不依赖 Arduino 与 U8g2，编译命令见下方。
+ */
+// g++ -O2 -std=c++11 -pthread -DHYDROGEN_HOST_THREADS=1 -Isrc examples/host_benchmark.cpp src/core/*.cpp src/ui/*.cpp -o host_benchmark
+// ./host_benchmark
+// 加 -DHYDROGEN_ENABLE_STATS=1 时最后输出逐帧统计 (对比两次编译的耗时即统计本身的开销)
+#include "HydrogenUI.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 基准依赖 ThreadedFramebufferHAL 与多线程 TileRenderer，所有翻译单元都要以同一宏编译
+#if !HYDROGEN_HOST_THREADS
+#error "host_benchmark 需要以 -DHYDROGEN_HOST_THREADS=1 编译"
+#endif
+
+using namespace Hydrogen;
+
+// 统计堆分配次数，用于检查稳态帧是否分配内存 (new[] 默认也经过这里)；
+// 同时统计仍在使用的字节数，分配大小记录在每块前面的头部 (保持 16 字节对齐)
+// noinline：避免 GCC 内联后把 malloc/free 误报为与 new/delete 不匹配
+static unsigned long heapAllocations = 0;
+static std::size_t heapLiveBytes = 0;
+static const std::size_t HEAP_HEADER = 16;
+
+__attribute__((noinline)) void* operator new(std::size_t size) {
+    ++heapAllocations;
+    char* p = static_cast<char*>(std::malloc(size + HEAP_HEADER));
+    if (!p) throw std::bad_alloc();
+    *reinterpret_cast<std::size_t*>(p) = size;
+    heapLiveBytes += size;
+    return p + HEAP_HEADER;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    if (!p) return;
+    char* block = static_cast<char*>(p) - HEAP_HEADER;
+    heapLiveBytes -= *reinterpret_cast<std::size_t*>(block);
+    std::free(block);
+}
+
+namespace {
+
+/**
+ * @brief 所有批量接口都退回 HAL 默认实现的帧缓冲
+ * 每个像素一次虚函数调用，代表优化前的路径。
+ */
+class PerPixelHAL : public FramebufferHAL {
+public:
+    PerPixelHAL() : FramebufferHAL(128, 64) {}
+    void drawHLine(int x, int y, int w, uint8_t c) override { HAL::drawHLine(x, y, w, c); }
+    void drawVLine(int x, int y, int h, uint8_t c) override { HAL::drawVLine(x, y, h, c); }
+    void fillRect(int x, int y, int w, int h, uint8_t c) override { HAL::fillRect(x, y, w, h, c); }
+    void drawXBM(int x, int y, int w, int h, const uint8_t* b) override { HAL::drawXBM(x, y, w, h, b); }
+};
+
+typedef std::chrono::steady_clock Clock;
+
+template <typename Fn>
+double measureUs(int iterations, Fn fn) {
+    for (int i = 0; i < iterations / 10 + 1; ++i) fn(i); // 预热
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < iterations; ++i) fn(i);
+    std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+template <typename Fn>
+void compare(const char* name, HAL& slowHal, HAL& fastHal, int iterations, Fn fn) {
+    Graphics slow(&slowHal);
+    Graphics fast(&fastHal);
+    double slowUs = measureUs(iterations, [&](int i) { fn(slow, i); });
+    double fastUs = measureUs(iterations, [&](int i) { fn(fast, i); });
+    printf("  %-24s %10.2f us %10.2f us %8.1fx\n", name, slowUs, fastUs, slowUs / fastUs);
+}
+
+void benchFills() {
+    printf("[fills] per-pixel HAL vs FramebufferHAL\n");
+    printf("  %-24s %13s %13s %9s\n", "primitive", "per-pixel", "framebuffer", "speedup");
+
+    PerPixelHAL pixelHal;
+    FramebufferHAL fbHal(128, 64);
+    const int N = 2000;
+
+    compare("fillRect 128x64", pixelHal, fbHal, N, [](Graphics& g, int) {
+        g.fillRect(0, 0, 128, 64);
+    });
+    compare("fillRect 40x12", pixelHal, fbHal, N, [](Graphics& g, int i) {
+        g.fillRect(i % 88, i % 52, 40, 12);
+    });
+    compare("fillCircle r=30", pixelHal, fbHal, N, [](Graphics& g, int) {
+        g.fillCircle(64, 32, 30);
+    });
+    compare("drawRect 120x56", pixelHal, fbHal, N, [](Graphics& g, int) {
+        g.drawRect(4, 4, 120, 56);
+    });
+    compare("drawRoundRect 120x16", pixelHal, fbHal, N, [](Graphics& g, int) {
+        g.drawRoundRect(2, 20, 120, 16, 2);
+    });
+}
+
+/**
+ * @brief 缓动曲线的解析式 (查找表由它离线生成)
+ */
+double curveReference(Curve curve, double t) {
+    switch (curve) {
+    case Curve::Linear: return t;
+    case Curve::EaseIn: return t * t * t;
+    case Curve::EaseOut: return 1 - (1 - t) * (1 - t) * (1 - t);
+    case Curve::EaseInOut: return t < 0.5 ? 4 * t * t * t : 1 - (2 - 2 * t) * (2 - 2 * t) * (2 - 2 * t) / 2;
+    case Curve::Back: return 1 + 2.70158 * (t - 1) * (t - 1) * (t - 1) + 1.70158 * (t - 1) * (t - 1);
+    case Curve::Bounce:
+        if (t < 1 / 2.75) return 7.5625 * t * t;
+        if (t < 2 / 2.75) { t -= 1.5 / 2.75; return 7.5625 * t * t + 0.75; }
+        if (t < 2.5 / 2.75) { t -= 2.25 / 2.75; return 7.5625 * t * t + 0.9375; }
+        t -= 2.625 / 2.75;
+        return 7.5625 * t * t + 0.984375;
+    }
+    return t;
+}
+
+/**
+ * @brief 参照值：与 Animator 相同的 32 段查找表插值，采样点由解析式按 2^14 缩放取整
+ * (与离线生成查找表的方法一致)，插值后以 double 计算，不受 Scalar 类型影响
+ */
+double tweenReference(Curve curve, uint32_t elapsed, uint32_t duration, int from, int to) {
+    int32_t c;
+    if (curve == Curve::Linear) {
+        c = (int32_t)(elapsed * 16384 / duration);
+    } else {
+        uint32_t pos = elapsed * (32 << 8) / duration;
+        int idx = (int)(pos >> 8);
+        int32_t frac = (int32_t)(pos & 0xFF);
+        int32_t a = (int32_t)std::lround(curveReference(curve, idx / 32.0) * 16384);
+        int32_t b = (int32_t)std::lround(curveReference(curve, (idx + 1) / 32.0) * 16384);
+        c = a + (b - a) * frac / 256;
+    }
+    return from + (to - from) * (c / 16384.0);
+}
+
+/**
+ * @brief 各动画器的补间：逐个逻辑步长采样，与参照值比较，并检查结束的步数
+ * 同一份检查在 float 与 HYDROGEN_FIXED_POINT 两种构建下运行 (参照值相同)，两者都通过即收敛一致；
+ * 步数不符或超出容差时返回 false，基准以非 0 退出。
+ */
+bool benchEasing() {
+#ifdef HYDROGEN_FIXED_POINT
+    printf("[easing] Animator tweens, Q16.16 Fixed build, vs double reference\n");
+#else
+    printf("[easing] Animator tweens, float build, vs double reference\n");
+#endif
+
+    // 各动画器实际使用的 (时长, 曲线) 与典型行程；scale 把属性值换算为屏幕像素
+    struct Case { const char* name; int from; int to; uint16_t duration; Curve curve; float scale; };
+    const Case cases[] = {
+        {"Camera offset -240 -> 0", -240, 0, 250, Curve::EaseOut, 1},
+        {"Camera offset 224 -> 0", 224, 0, 250, Curve::EaseOut, 1},
+        {"Camera offset -8192 -> 0", -MAX_TWEEN_OFFSET, 0, 250, Curve::EaseOut, 1},
+        {"List select -96 -> 0", -96, 0, 200, Curve::EaseOut, 1},
+        {"Switch.knobX 0 -> 20", 0, 20, 150, Curve::EaseInOut, 1},
+        {"ProgressBar 0 -> 1", 0, 1, 300, Curve::EaseOut, 120},
+        {"Back 0 -> 64", 0, 64, 400, Curve::Back, 1},
+        {"Bounce 0 -> 64", 0, 64, 400, Curve::Bounce, 1},
+    };
+    // 数值类型带来的误差上限 (像素)：Q16.16 的舍入远小于此值，超出说明定点路径有误。
+    // 另加曲线值的一个最小单位 (2^-14) 乘以行程：行程很长时查找表插值的取整在两种构建中相同
+    const double TOLERANCE_PX = 0.05;
+
+    printf("  %-24s %10s %10s %12s\n", "tween", "end tick", "expected", "max err px");
+    bool ok = true;
+    for (const Case& c : cases) {
+        Animator animator;
+        Scalar value = Scalar(c.from);
+        animator.animate(&value, Scalar(c.to), c.duration, c.curve);
+        int ticks = 0;
+        double maxErr = 0;
+        while (animator.isAnimating(&value) && ticks < 1000) {
+            animator.update(HYDROGEN_TICK_MS);
+            ticks++;
+            uint32_t elapsed = std::min<uint32_t>((uint32_t)ticks * HYDROGEN_TICK_MS, c.duration);
+            double expected = elapsed >= c.duration ? c.to : tweenReference(c.curve, elapsed, c.duration, c.from, c.to);
+            double err = std::abs((double)scalarToFloat(value) - expected) * c.scale;
+            maxErr = std::max(maxErr, err);
+        }
+        int expectedTicks = (c.duration + HYDROGEN_TICK_MS - 1) / HYDROGEN_TICK_MS;
+        double tolerance = TOLERANCE_PX + std::abs(c.to - c.from) * c.scale / 16384.0;
+        bool pass = ticks == expectedTicks && maxErr <= tolerance && value == Scalar(c.to);
+        ok = ok && pass;
+        printf("  %-24s %10d %10d %12.3f%s\n", c.name, ticks, expectedTicks, maxErr, pass ? "" : "  (differs)");
+    }
+    return ok;
+}
+
+void benchAnimator() {
+    printf("[animator] cost of one tick by active tween count\n");
+    printf("  %-24s %10s\n", "active tweens", "per tick");
+
+    const int counts[] = {0, 1, 4, Animator::MAX_TWEENS};
+    for (int active : counts) {
+        Animator animator;
+        Scalar values[Animator::MAX_TWEENS];
+        // 时长足够长，测量期间补间不会结束
+        for (int i = 0; i < active; ++i) {
+            values[i] = 0;
+            animator.animate(&values[i], Scalar(100), 60000, Curve(i % 6));
+        }
+        double us = measureUs(2000, [&](int) { animator.update(1); });
+        char name[32];
+        snprintf(name, sizeof(name), "%d", active);
+        printf("  %-24s %7.3f us\n", name, us);
+    }
+}
+
+/**
+ * @brief 模拟 U8g2 中文字库的文本路径
+ * 约 400 个 12x12 字形 (与 wqy12_t_chinese1 规模相当)。与 U8g2 一样逐字解码 UTF-8、
+ * 在 Unicode 表中线性查找字形，并把每行的连续像素作为水平线段绘制。
+ * 真实的 U8g2 还需要逐位解码 RLE 位流，因此这里的开销是偏低的估计。
+ */
+class CjkFontHAL : public FramebufferHAL {
+public:
+    static const int GLYPHS = 400;
+    static const int GLYPH_BYTES = 24; // 12x12，每行 2 字节
+    uint16_t codepoints[GLYPHS];
+    uint8_t bitmaps[GLYPHS * GLYPH_BYTES];
+
+    CjkFontHAL() : FramebufferHAL(128, 64) {
+        uint32_t seed = 1;
+        for (int i = 0; i < GLYPHS; ++i) codepoints[i] = (uint16_t)(0x4E00 + i * 37);
+        for (int i = 0; i < GLYPHS * GLYPH_BYTES; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            bitmaps[i] = (uint8_t)(seed >> 16) & ((i & 1) ? 0x0F : 0xFF); // 每行只用 12 位
+        }
+    }
+
+    int find(uint32_t cp) const {
+        for (int i = 0; i < GLYPHS; ++i) {
+            if (codepoints[i] == cp) return i;
+        }
+        return -1;
+    }
+
+    int getStrWidth(const char* s) override {
+        int w = 0;
+        while (*s) {
+            if (find(decodeUtf8(s)) >= 0) w += 12;
+        }
+        return w;
+    }
+
+    void drawStr(int x, int y, const char* s) override {
+        while (*s) {
+            int g = find(decodeUtf8(s));
+            if (g < 0) continue;
+            const uint8_t* bits = &bitmaps[g * GLYPH_BYTES];
+            for (int j = 0; j < 12; ++j) {
+                int row = bits[j * 2] | (bits[j * 2 + 1] << 8);
+                for (int i = 0; i < 12;) {
+                    if (!(row & (1 << i))) { ++i; continue; }
+                    int start = i;
+                    while (i < 12 && (row & (1 << i))) ++i;
+                    drawHLine(x + start, y - 10 + j, i - start, 1);
+                }
+            }
+            x += 12;
+        }
+    }
+
+    /**
+     * @brief 以同一组字形构建原生字体
+     */
+    void buildFont(Font& font, std::vector<FontGlyph>& glyphs) const {
+        glyphs.clear();
+        for (int i = 0; i < GLYPHS; ++i) {
+            glyphs.push_back(FontGlyph{(uint32_t)(i * GLYPH_BYTES), 12, 12, 12, 0, -10});
+        }
+        font = Font{codepoints, glyphs.data(), bitmaps, (uint16_t)GLYPHS, 10, 2, 0};
+    }
+};
+
+std::string cjkText(const CjkFontHAL& hal, int seed, int chars) {
+    std::string s;
+    for (int k = 0; k < chars; ++k) {
+        uint32_t cp = hal.codepoints[(seed * 7 + k * 13) % CjkFontHAL::GLYPHS];
+        s += (char)(0xE0 | (cp >> 12));
+        s += (char)(0x80 | ((cp >> 6) & 0x3F));
+        s += (char)(0x80 | (cp & 0x3F));
+    }
+    return s;
+}
+
+void benchFonts() {
+    printf("[fonts] drawing a 6-character CJK line (400-glyph font)\n");
+
+    CjkFontHAL hal;
+    Graphics g(&hal);
+    Font font;
+    std::vector<FontGlyph> glyphs;
+    hal.buildFont(font, glyphs);
+
+    std::vector<std::string> lines;
+    for (int i = 0; i < 64; ++i) lines.push_back(cjkText(hal, i, 6));
+
+    const int N = 20000;
+    double u8g2Us = measureUs(N, [&](int i) { g.drawText(4, 20 + (i & 15), lines[i & 63]); });
+    g.setFont(&font);
+    double nativeUs = measureUs(N, [&](int i) { g.drawText(4, 20 + (i & 15), lines[i & 63]); });
+    printf("  u8g2-style HAL path %.2f us, native font %.2f us (%.1fx)\n", u8g2Us, nativeUs, u8g2Us / nativeUs);
+}
+
+void benchTextWidth() {
+    printf("[text width] 200-item CJK menu, 4 visible rows measured per frame\n");
+
+    CjkFontHAL hal;
+    Graphics g(&hal);
+
+    // 每项 4~6 个汉字
+    std::vector<std::string> items;
+    for (int i = 0; i < 200; ++i) items.push_back(cjkText(hal, i, 4 + i % 3));
+
+    // 选中项每 8 帧下移一行，列表随之滚动
+    const int N = 4000;
+    auto rows = [&](int frame, int row) -> const std::string& {
+        int first = (frame / 8) % (200 - 4);
+        return items[first + row];
+    };
+    volatile int sink = 0;
+    double directUs = measureUs(N, [&](int f) {
+        for (int r = 0; r < 4; ++r) sink += hal.getStrWidth(rows(f, r).c_str());
+    });
+    g.getTextCache().resetStats();
+    double cachedUs = measureUs(N, [&](int f) {
+        for (int r = 0; r < 4; ++r) sink += g.getTextWidth(rows(f, r));
+    });
+    const TextWidthCache& cache = g.getTextCache();
+    printf("  per frame: HAL %.2f us, cached %.2f us (%.1fx), hit rate %.1f%% (%lu hits / %lu misses)\n",
+           directUs, cachedUs, directUs / cachedUs,
+           100.0 * cache.getHits() / (cache.getHits() + cache.getMisses()), cache.getHits(), cache.getMisses());
+}
+
+/**
+ * @brief 时钟由测试手动推进的帧缓冲
+ * 可选地模拟总线传输耗时：每推送一个字节，时钟前进 usPerByte 微秒。
+ */
+class ManualClockHAL : public FramebufferHAL {
+public:
+    unsigned long us;
+    unsigned long usPerByte;
+    ManualClockHAL() : FramebufferHAL(128, 64), us(0), usPerByte(0) {}
+    unsigned long getMillis() override { return us / 1000; }
+    unsigned long getMicros() override { return us; }
+    void update() override { us += usPerByte * getBufferSize(); }
+    void updateRegion(int x, int y, int w, int h) override {
+        // 与 FramebufferHAL 相同，按页对齐
+        if (x < 0) { w += x; x = 0; }
+        if (y < 0) { h += y; y = 0; }
+        if (x + w > getWidth()) w = getWidth() - x;
+        if (y + h > getHeight()) h = getHeight() - y;
+        if (w <= 0 || h <= 0) return;
+        us += usPerByte * w * (((y + h - 1) >> 3) - (y >> 3) + 1);
+    }
+};
+
+ManualClockHAL clockHal;
+List* demoList = nullptr;
+
+/**
+ * @brief 在手动时钟上搭建一个 20 行的列表
+ */
+void setupDemo() {
+    App.begin(&clockHal);
+    demoList = new List(0, 0, 128, 64);
+    for (int i = 0; i < 20; ++i) demoList->addItem(new Label(0, 0, "Item", true));
+    App.add(demoList);
+}
+
+void benchFrameRate() {
+    printf("[frame rate] time for a 10-row scroll to settle, by render interval\n");
+    printf("  %-24s %10s %10s\n", "render interval", "settle ms", "frames");
+
+    ManualClockHAL& hal = clockHal;
+    List* list = demoList;
+
+    const unsigned long intervals[] = {8, 16, 33, 66, 100};
+    for (unsigned long interval : intervals) {
+        // 先回到顶部并静止
+        for (int i = 0; i < 10; ++i) list->prev();
+        do { hal.us += interval * 1000; App.update(); } while (!App.isIdle());
+
+        for (int i = 0; i < 10; ++i) list->next();
+        unsigned long start = hal.getMillis();
+        unsigned long frames = App.getFrameCount();
+        do { hal.us += interval * 1000; App.update(); } while (!App.isIdle());
+        char name[32];
+        snprintf(name, sizeof(name), "%lu ms", interval);
+        printf("  %-24s %10lu %10lu\n", name, hal.getMillis() - start, App.getFrameCount() - frames);
+    }
+}
+
+void benchGovernor() {
+    printf("[governor] 16 ms budget on a simulated 400 kHz I2C bus (~25 us/byte)\n");
+    printf("  %-24s %6s %9s %8s %8s\n", "phase", "level", "overruns", "frames", "sim ms");
+
+    ManualClockHAL& hal = clockHal;
+    FrameGovernor& gov = App.getGovernor();
+    hal.usPerByte = 25;
+    App.add(new MatrixRain(0, 0, 128, 64));
+
+    // 主循环：每次 update() 之间空闲 2ms
+    auto run = [&](const char* name, int updates, int scrollEvery) {
+        unsigned long frames = App.getFrameCount();
+        unsigned long overruns = gov.getOverruns();
+        unsigned long start = hal.us;
+        for (int i = 0; i < updates; ++i) {
+            if (scrollEvery > 0 && i % scrollEvery == 0) demoList->next();
+            hal.us += 2000;
+            App.update();
+        }
+        printf("  %-24s %6d %9lu %8lu %8lu\n", name, gov.getLevel(), gov.getOverruns() - overruns,
+               App.getFrameCount() - frames, (hal.us - start) / 1000);
+    };
+
+    run("rain", 300, 0);
+    run("rain + fast scroll", 300, 10);
+    run("scroll stops", 300, 0);
+    run("idle", 3000, 0);
+
+    hal.usPerByte = 0;
+}
+
+/**
+ * @brief 稳态帧的堆分配次数
+ * 列表滚动、开关切换、进度条变化、FPS 文本更新与数字雨同时进行，期间不应有任何堆分配。
+ * @return 测得的分配次数
+ */
+unsigned long benchAllocations() {
+    printf("[allocations] heap allocations in steady-state frames\n");
+
+    ManualClockHAL& hal = clockHal;
+    FPSCounter* fps = new FPSCounter(0, 0);
+    fps->setShowSkipped(true);
+    Switch* sw = new Switch(0, 0, 128, 16, StaticText("Wi-Fi"));
+    ProgressBar* bar = new ProgressBar(0, 0, 128, 16, StaticText("Volume"), 0.5f);
+    demoList->addItem(sw);
+    demoList->addItem(bar);
+    demoList->addItem(StaticText("About"));
+    App.add(fps);
+
+    auto run = [&](int updates) {
+        for (int i = 0; i < updates; ++i) {
+            if (i % 10 == 0) demoList->next();
+            if (i % 25 == 0) sw->toggle();
+            if (i % 15 == 0) bar->setValue((i % 100) / 100.0f);
+            hal.us += 5000;
+            App.update();
+        }
+    };
+
+    run(500); // 预热：让各控件、缓存进入稳定状态
+    unsigned long frames = App.getFrameCount();
+    unsigned long before = heapAllocations;
+    run(2000);
+    unsigned long allocations = heapAllocations - before;
+    printf("  %lu frames drawn, %lu allocations (%.2f per frame)\n", App.getFrameCount() - frames, allocations,
+           (double)allocations / (App.getFrameCount() - frames));
+    return allocations;
+}
+
+/**
+ * @brief 按需生成文件名的数据源
+ */
+class FileSource : public ListDataSource {
+    int rows;
+    mutable char name[24];
+
+public:
+    explicit FileSource(int rows) : rows(rows) {}
+    int count() const override { return rows; }
+    const char* textAt(int index) const override {
+        TextBuilder(name, sizeof(name)).append("file_").appendPadded(index, 6).append(".log");
+        return name;
+    }
+};
+
+void benchVirtualList() {
+    const int ROWS = 100000;
+    printf("[virtual list] scrolling a %d-row list (one row per 4 ticks)\n", ROWS);
+    printf("  %-20s %14s %10s\n", "mode", "build allocs", "us/tick");
+
+    Graphics& g = *App.getGraphics();
+    auto run = [&](const char* name, List* list, unsigned long buildAllocations) {
+        double us = measureUs(4000, [&](int i) {
+            if (i % 4 == 0) list->next();
+            App.getAnimator().update(HYDROGEN_TICK_MS);
+            list->update();
+            list->draw(g);
+        });
+        printf("  %-20s %14lu %10.2f\n", name, buildAllocations, us);
+        delete list;
+    };
+
+    unsigned long before = heapAllocations;
+    List* classic = new List(0, 0, 128, 64);
+    char name[24];
+    for (int i = 0; i < ROWS; ++i) {
+        TextBuilder(name, sizeof(name)).append("file_").appendPadded(i, 6).append(".log");
+        classic->addItem(new Label(0, 0, name));
+    }
+    run("Label per row", classic, heapAllocations - before);
+
+    FileSource files(ROWS);
+    before = heapAllocations;
+    List* virtualized = new List(0, 0, 128, 64);
+    virtualized->setDataSource(&files);
+    run("data source", virtualized, heapAllocations - before);
+}
+
+/**
+ * @brief 10 万行列表的两端之间跳转：滚动位置远超 Q16.16 的整数范围 (±32767)，
+ * 相机应单调地移动到目标，选中框画在目标行上 (float 与定点数两种构建运行同一检查)
+ * @return 所有跳转都到位时为 true
+ */
+bool benchLongList() {
+    const int ROWS = 100000;
+    printf("[long list] jumping between the ends of a %d-row list\n", ROWS);
+    printf("  %-24s %10s %10s %8s\n", "jump", "camera y", "expected", "box y");
+
+    ManualClockHAL& hal = clockHal;
+    App.clear();
+    FileSource files(ROWS);
+    List* list = new List(0, 0, 128, 64);
+    list->setDataSource(&files);
+    App.add(list);
+    App.getCamera().jumpTo(0, 0);
+    hal.us += HYDROGEN_TICK_MS * 1000;
+    App.update(); // 首帧：选中框的初始尺寸直接到位，并绘制 add() 失效的区域
+
+    const int maxCamY = ROWS * 16 - 64;
+    // 推进到动画结束：相机逐帧单调地接近目标，最后停在目标上，选中框的上边位于 boxY；
+    // 动画结束后不再重绘 (复用的行在绘制中重新绑定时不应让下一帧整屏失效)
+    int extraFrames = 0;
+    auto settle = [&](const char* name, int expectedCamY, int boxY) {
+        int startY = App.getCamera().getY();
+        bool monotonic = true;
+        int last = startY;
+        for (int i = 0; i < 40; ++i) {
+            hal.us += HYDROGEN_TICK_MS * 1000;
+            bool animating = App.getCamera().isMoving() || list->isAnimating();
+            if (App.update() && !animating) ++extraFrames;
+            int y = App.getCamera().getY();
+            if (expectedCamY >= startY ? (y < last || y > expectedCamY) : (y > last || y < expectedCamY)) {
+                monotonic = false;
+            }
+            last = y;
+        }
+        int camY = App.getGraphics()->getCamY();
+        bool boxOk = hal.getPixel(6, boxY) && !hal.getPixel(6, boxY - 2);
+        bool pass = monotonic && camY == expectedCamY && boxOk;
+        printf("  %-24s %10d %10d %8d%s\n", name, camY, expectedCamY, boxY, pass ? "" : "  (wrong)");
+        return pass;
+    };
+
+    bool ok = settle("initial", 0, 0);
+    list->prev(); // 从第一行回到最后一行
+    ok = settle("first -> last", maxCamY, 48) && ok;
+    list->prev();
+    ok = settle("last -> last - 1", maxCamY, 32) && ok;
+    list->next();
+    list->next(); // 回到第一行
+    ok = settle("last -> first", 0, 0) && ok;
+    printf("  frames redrawn after the animation ended: %d%s\n", extraFrames, extraFrames ? "  (wrong)" : "");
+    App.clear();
+    return ok && extraFrames == 0;
+}
+
+/**
+ * @brief 可变行高的布局查询：等高 O(1)、树状数组 O(log n)，对照逐行累加
+ */
+/**
+ * @brief 按字母分组的联系人列表：26 个分组标题，每组 400 项，每 8 项中只有 1 项可选中
+ */
+class ContactSource : public ListDataSource {
+    mutable char name[24];
+
+public:
+    static const int PER_SECTION = 400;
+    int count() const override { return 26 * (PER_SECTION + 1); }
+    const char* textAt(int index) const override {
+        int section = index / (PER_SECTION + 1);
+        int item = index % (PER_SECTION + 1);
+        TextBuilder out(name, sizeof(name));
+        out.append((char)('A' + section));
+        if (item > 0) out.append((char)('a' + item % 26)).append((char)('a' + item / 26 % 26)).append(item);
+        return name;
+    }
+    bool isInteractive(int index) const override { return index % (PER_SECTION + 1) % 8 == 1; }
+    bool isSection(int index) const override { return index % (PER_SECTION + 1) == 0; }
+};
+
+void benchNavigation() {
+    ContactSource contacts;
+    printf("[navigation] %d-row list, 26 sections, 1 in 8 rows selectable\n", contacts.count());
+
+    List* list = new List(0, 0, 128, 64);
+    list->setDataSource(&contacts);
+    double nextUs = measureUs(100000, [&](int) { list->next(); });
+    double sectionUs = measureUs(100000, [&](int) { list->nextSection(); });
+    double jumpUs = measureUs(20000, [&](int i) {
+        char prefix[3] = {(char)('a' + i % 26), (char)('a' + i / 26 % 26), '\0'};
+        list->jumpTo(prefix);
+    });
+    printf("  next %.3f us, nextSection %.3f us, jumpTo(prefix) %.2f us\n", nextUs, sectionUs, jumpUs);
+
+    // 逐字输入 "Mb"：第一个字符扫描全部行，之后只在上一次的结果中筛选
+    const int N = 200;
+    std::chrono::duration<double, std::micro> full(0), narrow(0);
+    for (int i = 0; i < N; ++i) {
+        list->setFilter(nullptr);
+        Clock::time_point t0 = Clock::now();
+        list->setFilter("M");
+        Clock::time_point t1 = Clock::now();
+        list->setFilter("Mb");
+        narrow += Clock::now() - t1;
+        full += t1 - t0;
+    }
+    printf("  filter \"M\" (full scan) %.1f us, then \"Mb\" (narrowing) %.1f us -> %d rows\n",
+           full.count() / N, narrow.count() / N, list->getItemCount());
+    delete list;
+}
+
+void benchListLayout() {
+    const int ROWS = 100000;
+    printf("[list layout] %d rows, every 7th row 32 px tall\n", ROWS);
+
+    std::vector<int> heights(ROWS);
+    ListLayout uniform, mixed;
+    uniform.reset(ROWS, 16);
+    mixed.reset(ROWS, 16);
+    for (int i = 0; i < ROWS; ++i) {
+        heights[i] = i % 7 == 3 ? 32 : 16;
+        if (heights[i] != 16) mixed.setHeight(i, heights[i]);
+    }
+    int total = mixed.totalHeight();
+
+    volatile int sink = 0;
+    const int N = 200000;
+    double uniformUs = measureUs(N, [&](int i) {
+        sink = uniform.indexAt((int)((i * 2654435761u) % (uint32_t)total)) + uniform.offsetOf(i % ROWS);
+    });
+    double fenwickUs = measureUs(N, [&](int i) {
+        sink = mixed.indexAt((int)((i * 2654435761u) % (uint32_t)total)) + mixed.offsetOf(i % ROWS);
+    });
+    double updateUs = measureUs(N, [&](int i) { mixed.setHeight((i * 7919) % ROWS, heights[(i * 7919) % ROWS]); });
+    double linearUs = measureUs(200, [&](int i) {
+        int target = (int)((i * 2654435761u) % (uint32_t)total);
+        int row = 0;
+        for (int y = 0; row < ROWS - 1 && y + heights[row] <= target; ++row) y += heights[row];
+        sink = row;
+    });
+    (void)sink;
+    printf("  row-at-offset + offset-of-row: uniform %.3f us, Fenwick %.3f us, linear scan %.1f us\n",
+           uniformUs, fenwickUs, linearUs);
+    printf("  row height update: %.3f us\n", updateUs);
+}
+
+/**
+ * @brief 以 50 Hz 记录传感器数据的日志终端：对照旧的 vector<string> + erase(begin) 实现
+ */
+void benchLogger() {
+    const int LINES = 50;
+    const int N = 100000;
+    printf("[logger] %d-line log, %d logf calls\n", LINES, N);
+
+    std::vector<std::string> naive;
+    unsigned long before = heapAllocations;
+    double naiveUs = measureUs(N, [&](int i) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "t=%d temp=%d.%d C", i, 20 + i % 7, i % 10);
+        naive.push_back(buf);
+        while ((int)naive.size() > LINES) naive.erase(naive.begin());
+    });
+    unsigned long naiveAllocations = heapAllocations - before;
+
+    Logger* logger = new Logger(0, 0, 128, 64, LINES);
+    before = heapAllocations;
+    double ringUs = measureUs(N, [&](int i) { logger->logf("t=%d temp=%d.%d C", i, 20 + i % 7, i % 10); });
+    unsigned long ringAllocations = heapAllocations - before;
+
+    printf("  vector<string>: %.3f us/line, %lu allocations\n", naiveUs, naiveAllocations);
+    printf("  ring buffer:    %.3f us/line, %lu allocations\n", ringUs, ringAllocations);
+    delete logger;
+}
+
+/**
+ * @brief 输入延迟：编码器事件在两次 update() 之间的随机时刻到达，统计到画面刷新完成的时间
+ */
+void benchInput() {
+    printf("[input] encoder events at random times, main loop calls update() every 2 ms\n");
+    printf("  %-24s %8s %8s %8s %8s\n", "bus", "events", "p50 ms", "p99 ms", "max ms");
+
+    ManualClockHAL& hal = clockHal;
+    auto run = [&](const char* name, unsigned long usPerByte) {
+        hal.usPerByte = usPerByte;
+        App.resetInputLatency();
+        uint32_t seed = 12345;
+        for (int i = 0; i < 3000; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            unsigned long at = (seed >> 8) % 2000;
+            if ((seed >> 20) % 5 == 0) {
+                hal.us += at;
+                App.postEvent(InputEvent::encoder(1));
+                hal.us += 2000 - at;
+            } else {
+                hal.us += 2000;
+            }
+            App.update();
+        }
+        const LatencyStats& latency = App.getInputLatency();
+        printf("  %-24s %8lu %8.2f %8.2f %8.2f\n", name, latency.getCount(), latency.percentile(50) / 1000.0,
+               latency.percentile(99) / 1000.0, latency.getMax() / 1000.0);
+    };
+
+    run("none", 0);
+    run("400 kHz I2C (25 us/B)", 25);
+    hal.usPerByte = 0;
+    if (App.getDroppedEvents()) printf("  %lu events dropped\n", App.getDroppedEvents());
+}
+
+/**
+ * @brief 连续输入时逻辑时钟与实际时间一致：每隔几毫秒投递一个事件，补间进度应跟随 getMillis()
+ * 输入提前执行的步长从之后经过的时间中偿还，进度最多领先一个步长 (加上开始时不足一个步长的余量)。
+ * @return 各输入间隔下偏差都在容差内时为 true
+ */
+bool benchInputClock() {
+    printf("[input clock] linear 2 s tween while encoder events arrive every N ms\n");
+    printf("  %-24s %12s %12s\n", "event interval", "max lead ms", "max lag ms");
+
+    ManualClockHAL& hal = clockHal;
+    const int DURATION = 2000;
+    const int TOLERANCE_MS = 2 * HYDROGEN_TICK_MS;
+    const int intervals[] = {1, 3, 7, 16, 40};
+    bool ok = true;
+    for (int interval : intervals) {
+        App.update();
+        // 属性值即补间已推进的毫秒数
+        static Scalar progress;
+        progress = Scalar(0);
+        App.getAnimator().animate(&progress, Scalar(DURATION), DURATION, Curve::Linear);
+        unsigned long startMs = hal.getMillis();
+        long maxLead = 0, maxLag = 0;
+        for (;;) {
+            hal.us += (unsigned long)interval * 1000;
+            App.postEvent(InputEvent::encoder(interval % 2 ? 1 : -1));
+            App.update();
+            long wall = (long)(hal.getMillis() - startMs);
+            if (wall >= DURATION) break;
+            long diff = (long)scalarToInt(progress) - wall;
+            if (diff > maxLead) maxLead = diff;
+            if (-diff > maxLag) maxLag = -diff;
+        }
+        bool pass = maxLead <= TOLERANCE_MS && maxLag <= TOLERANCE_MS;
+        ok = ok && pass;
+        char label[24];
+        snprintf(label, sizeof(label), "%d ms", interval);
+        printf("  %-24s %12ld %12ld%s\n", label, maxLead, maxLag, pass ? "" : "  (drifts)");
+    }
+    return ok;
+}
+
+/**
+ * @brief 反复重建菜单 (如 Wi-Fi 扫描结果)：控件来自堆或内存池
+ */
+void benchArena() {
+    const int ROUNDS = 2000;
+    const int NETWORKS = 12;
+    printf("[arena] rebuilding a %d-entry menu %d times\n", NETWORKS, ROUNDS);
+    printf("  %-12s %16s %10s\n", "widgets", "heap allocs/menu", "us/menu");
+
+    static StaticWidgetArena<4096> arena;
+    auto run = [&](const char* name, WidgetArena* pool) {
+        unsigned long before = heapAllocations;
+        double us = measureUs(ROUNDS, [&](int) {
+            List* menu = makeWidget<List>(pool, 0, 0, 128, 64);
+            menu->setArena(pool);
+            for (int i = 0; i < NETWORKS; ++i) menu->addItem(StaticText("HomeNetwork"));
+            menu->addItem(makeWidget<Switch>(pool, 0, 0, 128, 16, StaticText("Auto-join")));
+            delete menu;
+        });
+        printf("  %-12s %16.1f %10.2f\n", name, (double)(heapAllocations - before) / ROUNDS, us);
+    };
+
+    run("heap", nullptr);
+    run("arena", &arena);
+    printf("  arena high-water mark %zu of %zu bytes, %lu overflows\n", arena.getHighWater(), arena.getCapacity(),
+           arena.getFailures());
+}
+
+/**
+ * @brief 由嵌套面板组成的长页面：整屏重绘的耗时，对照全部作为根控件的扁平结构
+ */
+void benchWidgetTree() {
+    const int PANELS = 100;
+    const int ROWS = 6;
+    printf("[widget tree] %d panels x %d rows on a %d px tall page, full redraw at the top\n", PANELS, ROWS,
+           PANELS * 40);
+
+    ManualClockHAL& hal = clockHal;
+    auto run = [&](const char* name, bool nested) {
+        App.clear();
+        App.getCamera().jumpTo(0, 0);
+        Panel* page = new Panel(0, 0, 128, PANELS * 40);
+        if (nested) App.add(page);
+        for (int p = 0; p < PANELS; ++p) {
+            int y = p * 40;
+            if (nested) {
+                Panel* panel = new Panel(0, y, 128, 40, true);
+                for (int r = 0; r < ROWS; ++r) panel->addChild(new ProgressBar(4, 2 + r * 6, 120, 5, "", 0.5f));
+                page->addChild(panel);
+            } else {
+                App.add(new Panel(0, y, 128, 40, true));
+                for (int r = 0; r < ROWS; ++r) App.add(new ProgressBar(4, y + 2 + r * 6, 120, 5, "", 0.5f));
+            }
+        }
+        double us = measureUs(2000, [&](int) {
+            App.invalidateAll();
+            hal.us += 1000;
+            App.update();
+        });
+        printf("  %-10s %8.1f us/frame\n", name, us);
+        if (!nested) delete page;
+    };
+
+    run("flat", false);
+    run("nested", true);
+    App.clear();
+}
+
+/// 启动对比用的设置菜单 (编译期常量，位于 rodata)
+constexpr MenuEntry SETTINGS_MENU[] = {
+    menuSection("Network"),   menuSwitch("Wi-Fi", true),       menuSwitch("Bluetooth"),
+    menuSubmenu("Networks"),  menuSubmenu("Hotspot"),          menuSection("Display"),
+    menuProgress("Brightness", 0.8f), menuSwitch("Auto dim", true), menuSubmenu("Theme"),
+    menuItem("Sleep after"),  menuSection("Sound"),            menuProgress("Volume", 0.5f),
+    menuSwitch("Key clicks"), menuSubmenu("Alarm"),            menuSection("System"),
+    menuItem("Storage"),      menuItem("Date & time"),         menuItem("Language"),
+    menuItem("Reset"),        menuItem("About"),
+};
+typedef HYDROGEN_STATIC_MENU(SETTINGS_MENU) SettingsMenu;
+
+/**
+ * @brief 启动时构建设置菜单并画出第一帧：逐项 new 控件 (复制文本)，对照编译期的静态菜单
+ */
+void benchStaticMenu() {
+    const int ROUNDS = 2000;
+    const int N = (int)(sizeof(SETTINGS_MENU) / sizeof(SETTINGS_MENU[0]));
+    printf("[static menu] %d-entry settings menu, construction to first frame\n", N);
+    printf("  %-8s %12s %12s %16s\n", "menu", "heap allocs", "heap bytes", "us/first frame");
+
+    ManualClockHAL& hal = clockHal;
+    alignas(SettingsMenu) static unsigned char storage[sizeof(SettingsMenu)];
+
+    auto run = [&](const char* name, bool fixed) {
+        double totalUs = 0;
+        unsigned long allocs = 0;
+        std::size_t bytes = 0;
+        for (int round = 0; round < ROUNDS; ++round) {
+            App.clear();
+            hal.us += 50000;
+            App.update();
+
+            unsigned long allocsBefore = heapAllocations;
+            std::size_t bytesBefore = heapLiveBytes;
+            Clock::time_point start = Clock::now();
+            List* list = new List(0, 0, 128, 64);
+            if (fixed) {
+                list->setDataSource(new (storage) SettingsMenu());
+            } else {
+                // 与 list_demo 相同：文本以 std::string 复制进控件
+                for (int i = 0; i < N; ++i) {
+                    const MenuEntry& e = SETTINGS_MENU[i];
+                    std::string text(e.text);
+                    switch (e.kind) {
+                    case MenuEntry::Kind::Section: list->addSection(text); break;
+                    case MenuEntry::Kind::Switch: list->addItem(new Switch(0, 0, 120, e.height, text, e.initial != 0)); break;
+                    case MenuEntry::Kind::Progress:
+                        list->addItem(new ProgressBar(0, 0, 120, e.height, text, e.initial / 255.0f));
+                        break;
+                    case MenuEntry::Kind::Submenu: list->addItem(new Label(0, 0, text, true)); break;
+                    default: list->addItem(text); break;
+                    }
+                }
+            }
+            App.add(list);
+            hal.us += 50000;
+            App.update();
+            std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+            totalUs += elapsed.count();
+            allocs += heapAllocations - allocsBefore;
+            bytes += heapLiveBytes - bytesBefore;
+        }
+        printf("  %-8s %12.1f %12.1f %16.2f\n", name, (double)allocs / ROUNDS, (double)bytes / ROUNDS, totalUs / ROUNDS);
+    };
+
+    run("dynamic", false);
+    run("static", true);
+    App.clear();
+    printf("  static menu: %zu bytes of RAM state, %zu bytes of tables in rodata\n", sizeof(SettingsMenu),
+           sizeof(SETTINGS_MENU) + sizeof(SettingsMenu::Tables::offsets) + sizeof(SettingsMenu::Tables::slots));
+}
+
+/**
+ * @brief 由工作线程模拟总线的帧缓冲，图元逐像素绘制 (渲染耗时接近 MCU 上的毫秒级)
+ */
+class SlowThreadedHAL : public ThreadedFramebufferHAL {
+public:
+    SlowThreadedHAL() : ThreadedFramebufferHAL(128, 64) {}
+    void drawHLine(int x, int y, int w, uint8_t c) override { HAL::drawHLine(x, y, w, c); }
+    void drawVLine(int x, int y, int h, uint8_t c) override { HAL::drawVLine(x, y, h, c); }
+    void fillRect(int x, int y, int w, int h, uint8_t c) override { HAL::fillRect(x, y, w, h, c); }
+};
+
+/**
+ * @brief 整屏重绘的帧率：同步刷新 (绘制后等待传输) 对照双缓冲异步刷新 (绘制与传输重叠)
+ */
+void benchAsyncFlush() {
+    const int FRAMES = 300;
+    static SlowThreadedHAL hal;
+    App.begin(&hal);
+    App.clear();
+    for (int i = 0; i < 120; ++i) App.add(new RectWidget(i % 32, 0, 128 - (i % 32) * 2, 64, i % 2 == 0));
+
+    auto run = [&](bool async, FlushPolicy policy) {
+        hal.setDoubleBuffered(async);
+        App.setFlushPolicy(policy);
+        App.invalidateAll();
+        App.update();
+        hal.waitFlush();
+        Clock::time_point start = Clock::now();
+        unsigned long frames = App.getFrameCount();
+        for (int i = 0; i < FRAMES; ++i) {
+            App.invalidateAll();
+            App.update();
+        }
+        hal.waitFlush();
+        std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+        return (App.getFrameCount() - frames) * 1e6 / elapsed.count();
+    };
+
+    hal.setBusSpeed(0);
+    double renderFps = run(false, FlushPolicy::Wait);
+    double renderUs = 1e6 / renderFps;
+    printf("[async flush] full redraw, render only %.0f us/frame (%.0f fps)\n", renderUs, renderFps);
+    printf("  %-22s %10s %10s %8s\n", "bus us/frame", "sync fps", "async fps", "gain");
+
+    const double ratios[] = {0.5, 1.0, 2.0};
+    for (double ratio : ratios) {
+        double busUs = renderUs * ratio;
+        hal.setBusSpeed((unsigned long)(hal.getBufferSize() * 1e6 / busUs));
+        double syncFps = run(false, FlushPolicy::Wait);
+        double asyncFps = run(true, FlushPolicy::Wait);
+        char label[32];
+        snprintf(label, sizeof(label), "%.0f (%.1fx render)", busUs, ratio);
+        printf("  %-22s %10.0f %10.0f %7.2fx\n", label, syncFps, asyncFps, asyncFps / syncFps);
+    }
+
+    // Skip：总线忙时不等待，主循环留给其他任务；画面按总线速率更新
+    unsigned long deferred = App.getDeferredFlushes();
+    double skipFps = run(true, FlushPolicy::Skip);
+    printf("  skip policy at 2.0x: %.0f frames drawn/s, %lu flushes deferred\n", skipFps,
+           App.getDeferredFlushes() - deferred);
+
+    App.setFlushPolicy(FlushPolicy::Wait);
+    App.clear();
+    App.begin(&clockHal);
+}
+
+/**
+ * @brief 图元逐像素绘制的帧缓冲 (光栅化耗时接近 MCU 上的毫秒级)
+ */
+class SlowFramebufferHAL : public FramebufferHAL {
+public:
+    SlowFramebufferHAL() : FramebufferHAL(128, 64) {}
+    void drawHLine(int x, int y, int w, uint8_t c) override { HAL::drawHLine(x, y, w, c); }
+    void drawVLine(int x, int y, int h, uint8_t c) override { HAL::drawVLine(x, y, h, c); }
+    void fillRect(int x, int y, int w, int h, uint8_t c) override { HAL::fillRect(x, y, w, h, c); }
+};
+
+/**
+ * @brief 混合图元的场景：跨越条带边界的直线、圆、圆角矩形与原生字体文本
+ */
+class MixedSceneWidget : public Widget {
+    const Font* font;
+    std::vector<std::string> lines;
+public:
+    MixedSceneWidget(const Font* font, const CjkFontHAL& glyphs) : Widget(0, 0, 128, 64), font(font) {
+        for (int i = 0; i < 4; ++i) lines.push_back(cjkText(glyphs, i, 3 + i));
+    }
+    void draw(Graphics& g) override {
+        for (int i = 0; i < 8; ++i) g.drawLine(i * 17 - 8, 0, 127 - i * 11, 63);
+        g.drawCircle(32, 30, 27);
+        g.fillCircle(96, 34, 13);
+        g.drawCircle(100, 7, 11);
+        g.drawRoundRect(6, 5, 70, 22, 4);
+        g.drawRoundRect(50, 28, 75, 33, 6);
+        g.drawRoundRect(3, 46, 30, 15, 3);
+        g.setFont(font);
+        for (int i = 0; i < 4; ++i) g.drawText(2 + i * 9, 13 + i * 15, lines[i]);
+        g.setFont(nullptr);
+    }
+};
+
+/**
+ * @brief 混合场景分别直接绘制与经 TileRenderer 绘制，帧缓冲必须逐字节一致
+ * @return 所有工作者数下都一致时为 true
+ */
+bool checkTilePixels(SlowFramebufferHAL& fb) {
+    static CjkFontHAL glyphs;
+    static Font font;
+    static std::vector<FontGlyph> fontGlyphs;
+    glyphs.buildFont(font, fontGlyphs);
+
+    // 每次绘制前以固定图案填满缓冲区，漏画的字节不会与上一次的结果碰巧相同
+    auto render = [&](HAL* hal, std::vector<uint8_t>& out) {
+        memset(fb.getBuffer(), 0xA5, fb.getBufferSize());
+        App.begin(hal);
+        App.clear();
+        App.add(new MixedSceneWidget(&font, glyphs));
+        App.invalidateAll();
+        App.update();
+        App.clear();
+        out.assign(fb.getBuffer(), fb.getBuffer() + fb.getBufferSize());
+    };
+
+    std::vector<uint8_t> direct, tiled;
+    render(&fb, direct);
+    bool ok = true;
+    printf("  pixel check, lines/circles/round rects/native text:");
+    const int workerCounts[] = {1, 2, 4, 8};
+    for (int workers : workerCounts) {
+        TileRenderer tiles(&fb, workers);
+        render(&tiles, tiled);
+        bool same = memcmp(direct.data(), tiled.data(), direct.size()) == 0;
+        ok = ok && same;
+        printf(" %d:%s", workers, same ? "same" : "DIFFERS");
+    }
+    printf("\n");
+    return ok;
+}
+
+/**
+ * @brief 整屏重绘：直接绘制对照分带并行光栅化 (1/2/4/8 个工作者)，并检查两者的像素一致
+ * @return 像素一致时为 true
+ */
+bool benchTileRenderer() {
+    const int FRAMES = 300;
+    static SlowFramebufferHAL fb;
+    printf("[tile renderer] full redraw, 120 rect widgets, %u hardware threads\n",
+           std::thread::hardware_concurrency());
+    printf("  %-10s %8s %12s %8s %12s\n", "renderer", "bands", "us/frame", "speedup", "allocs/frame");
+
+    auto run = [&](HAL* hal) {
+        App.begin(hal);
+        App.clear();
+        for (int i = 0; i < 120; ++i) App.add(new RectWidget(i % 32, 0, 128 - (i % 32) * 2, 64, i % 2 == 0));
+        App.invalidateAll();
+        App.update();
+        unsigned long allocsBefore = heapAllocations;
+        double us = measureUs(FRAMES, [&](int) {
+            App.invalidateAll();
+            App.update();
+        });
+        unsigned long allocs = heapAllocations - allocsBefore;
+        App.clear();
+        return std::make_pair(us, (double)allocs / (FRAMES + FRAMES / 10 + 1));
+    };
+
+    std::pair<double, double> direct = run(&fb);
+    printf("  %-10s %8s %12.1f %8s %12.1f\n", "direct", "-", direct.first, "-", direct.second);
+    const int workerCounts[] = {1, 2, 4, 8};
+    for (int workers : workerCounts) {
+        TileRenderer tiles(&fb, workers);
+        std::pair<double, double> r = run(&tiles);
+        char label[16];
+        snprintf(label, sizeof(label), "%d worker%s", workers, workers > 1 ? "s" : "");
+        printf("  %-10s %8d %12.1f %7.2fx %12.1f\n", label, tiles.getBandCount(), r.first, direct.first / r.first,
+               r.second);
+    }
+    bool pixelsOk = checkTilePixels(fb);
+    App.begin(&clockHal);
+    return pixelsOk;
+}
+
+/**
+ * @brief 显示列表：整屏失效但内容不变的帧 (跳过光栅化与刷新)，以及每帧都在变化的帧 (录制的额外开销，
+ * 连续未命中后旁路)；容量不足的列表溢出后回放已录制部分、其余直接绘制，画面须与直接绘制逐字节相同
+ * @return 溢出帧的画面正确
+ */
+bool benchDisplayList() {
+    const int FRAMES = 2000;
+    static StaticDisplayList<256> displayList;
+    static StaticDisplayList<16> smallList;
+    printf("[display list] full-screen invalidation every frame, direct vs recorded\n");
+    printf("  %-14s %10s %10s %12s %12s %10s %8s %9s\n", "scene", "direct us", "list us", "direct B/f", "list B/f",
+           "unchanged", "miss %", "bypassed");
+
+    // usPerByte = 1：刷新推进的模拟时间即送出的字节数
+    unsigned long usPerByte = clockHal.usPerByte;
+    clockHal.usPerByte = 1;
+    struct Result {
+        double us;
+        double bytes;
+        unsigned long unchanged;
+        double missRate;
+        unsigned long bypassed;
+    };
+    auto run = [&](bool animated, DisplayList* list) {
+        App.clear();
+        App.setDisplayList(list);
+        if (list) list->resetStats();
+        srand(7);
+        if (animated) {
+            App.add(new MatrixRain(0, 0, 128, 64));
+        } else {
+            List* menu = new List(0, 0, 128, 64);
+            for (int i = 0; i < 20; ++i) menu->addItem(new Label(0, 0, "Item", true));
+            App.add(menu);
+        }
+        for (int i = 0; i < 100; ++i) {
+            clockHal.us += 16000;
+            App.update();
+        }
+        const int calls = FRAMES + FRAMES / 10 + 1; // measureUs 含预热
+        unsigned long unchanged = App.getUnchangedFrames();
+        unsigned long start = clockHal.us;
+        Result r;
+        r.us = measureUs(FRAMES, [&](int) {
+            clockHal.us += 16000;
+            App.invalidateAll();
+            App.update();
+        });
+        r.bytes = (double)(clockHal.us - start - 16000UL * calls) / calls;
+        r.unchanged = App.getUnchangedFrames() - unchanged;
+        r.missRate = 0;
+        r.bypassed = 0;
+        if (list) {
+            unsigned long compared = list->getHits() + list->getMisses();
+            r.missRate = compared ? 100.0 * list->getMisses() / compared : 0;
+            r.bypassed = list->getBypassedFrames();
+        }
+        App.setDisplayList(nullptr);
+        return r;
+    };
+
+    const char* names[] = {"static menu", "matrix rain"};
+    for (int animated = 0; animated < 2; ++animated) {
+        Result direct = run(animated != 0, nullptr);
+        Result recorded = run(animated != 0, &displayList);
+        printf("  %-14s %10.2f %10.2f %12.1f %12.1f %10lu %8.1f %9lu\n", names[animated], direct.us, recorded.us,
+               direct.bytes, recorded.bytes, recorded.unchanged, recorded.missRate, recorded.bypassed);
+    }
+    printf("  %zu bytes per command, list high water %zu/%zu commands\n", sizeof(DrawCommand),
+           displayList.getHighWater(), displayList.getCapacity());
+
+    // 溢出：混合场景约 20 条命令，16 条的列表在第 4 段文本处溢出 (帧缓冲的 HAL 字体不出像素，改用原生字体)
+    static CjkFontHAL glyphs;
+    static Font font;
+    static std::vector<FontGlyph> fontGlyphs;
+    glyphs.buildFont(font, fontGlyphs);
+    std::vector<uint8_t> expected;
+    bool pixelsOk = true;
+    for (int withList = 0; withList < 2; ++withList) {
+        App.clear();
+        App.setDisplayList(withList ? &smallList : nullptr);
+        App.add(new MixedSceneWidget(&font, glyphs));
+        memset(clockHal.getBuffer(), 0xA5, clockHal.getBufferSize());
+        clockHal.us += 16000;
+        App.invalidateAll();
+        App.update();
+        if (!withList) expected.assign(clockHal.getBuffer(), clockHal.getBuffer() + clockHal.getBufferSize());
+        else pixelsOk = memcmp(expected.data(), clockHal.getBuffer(), expected.size()) == 0;
+    }
+    printf("  overflow (%zu-command list): %lu misses, replay + direct pixels %s\n", smallList.getCapacity(),
+           smallList.getMisses(), pixelsOk ? "match" : "DIFFER");
+    App.setDisplayList(nullptr);
+    clockHal.usPerByte = usPerByte;
+    App.clear();
+    return pixelsOk;
+}
+
+/**
+ * @brief 统计刷新回调调用次数 (每次对应一次寻址加一段数据) 的帧缓冲，时钟手动推进
+ */
+class CountingFramebufferHAL : public FramebufferHAL {
+    static void onFlush(const FramebufferHAL&, int, int, int, int, void* user) {
+        ++*static_cast<unsigned long*>(user);
+    }
+
+public:
+    unsigned long us;
+    unsigned long runs;
+    CountingFramebufferHAL() : FramebufferHAL(128, 64), us(0), runs(0) { setFlushCallback(onFlush, &runs); }
+    unsigned long getMillis() override { return us / 1000; }
+    unsigned long getMicros() override { return us; }
+};
+
+/**
+ * @brief 帧差分：整屏失效 (控件无法上报精确脏区域) 时每帧实际送出的字节数
+ * 按 400 kHz I2C 估算总线时间：每字节 9 位 (22.5 us)，每段另加约 6 字节的寻址命令。
+ */
+void benchFrameDiff() {
+    const int FRAMES = 2000;
+    const double I2C_US_PER_BYTE = 22.5;
+    const int RUN_OVERHEAD_BYTES = 6;
+    static CountingFramebufferHAL fb;
+    printf("[frame diff] full-screen invalidation every frame, 128x64 over 400 kHz I2C\n");
+    printf("  %-14s %-5s %10s %10s %10s %12s\n", "scene", "diff", "us/frame", "B/frame", "runs/frame",
+           "i2c us/frame");
+
+    // 帧缓冲不带字库，画面变化来自进度条与选中框/滚动
+    const char* names[] = {"menu + bar", "scrolling menu"};
+    for (int scrolling = 0; scrolling < 2; ++scrolling) {
+        for (int diffing = 0; diffing < 2; ++diffing) {
+            fb.setDiffing(diffing != 0);
+            App.begin(&fb);
+            App.clear();
+            srand(7);
+            List* menu = new List(0, 0, 128, scrolling ? 64 : 48);
+            for (int i = 0; i < 20; ++i) menu->addItem(new Label(0, 0, "Item", true));
+            App.add(menu);
+            ProgressBar* bar = nullptr;
+            if (!scrolling) {
+                bar = new ProgressBar(0, 48, 128, 16, StaticText("Vol"), 0.0f);
+                App.add(bar);
+            }
+            for (int i = 0; i < 100; ++i) {
+                fb.us += 16000;
+                App.update();
+            }
+            const int calls = FRAMES + FRAMES / 10 + 1; // measureUs 含预热
+            unsigned long bytes = fb.getBytesSent();
+            unsigned long runs = fb.runs;
+            double us = measureUs(FRAMES, [&](int i) {
+                fb.us += 16000;
+                if (i % 8 == 0) {
+                    if (bar) bar->setValue((i / 8 % 10) / 10.0f);
+                    else App.postEvent(InputEvent::encoder(i % 320 < 160 ? 1 : -1));
+                }
+                App.invalidateAll();
+                App.update();
+            });
+            double bytesPerFrame = (double)(fb.getBytesSent() - bytes) / calls;
+            double runsPerFrame = (double)(fb.runs - runs) / calls;
+            printf("  %-14s %-5s %10.2f %10.1f %10.2f %12.0f\n", names[scrolling], diffing ? "on" : "off", us,
+                   bytesPerFrame, runsPerFrame, (bytesPerFrame + runsPerFrame * RUN_OVERHEAD_BYTES) * I2C_US_PER_BYTE);
+        }
+    }
+    fb.setDiffing(false);
+    App.clear();
+    App.begin(&clockHal);
+}
+
+/**
+ * @brief 逐帧统计：整屏重绘一个菜单 + 进度条 + 矩形组成的界面，输出 FrameStats 统计表
+ */
+void benchFrameStats() {
+#if HYDROGEN_ENABLE_STATS
+    const int FRAMES = 500;
+    static SlowFramebufferHAL fb;
+    printf("[frame stats] full redraw on a per-pixel framebuffer\n");
+    App.begin(&fb);
+    App.clear();
+    List* menu = new List(0, 0, 128, 48);
+    for (int i = 0; i < 20; ++i) menu->addItem(new Label(0, 0, "Item", true));
+    App.add(menu);
+    ProgressBar* bar = new ProgressBar(0, 48, 128, 16, StaticText("Vol"), 0.5f);
+    App.add(bar);
+    for (int i = 0; i < 8; ++i) App.add(new RectWidget(64 + i * 4, 4 + i * 4, 40, 20, i % 2 == 0));
+    App.getStats().reset();
+    double us = measureUs(FRAMES, [&](int) {
+        App.invalidateAll();
+        App.update();
+    });
+    printf("  %.1f us/frame with stats enabled\n", us);
+    App.getStats().dump([](const char* line, void*) { printf("  %s\n", line); });
+    App.clear();
+    App.begin(&clockHal);
+#else
+    printf("[frame stats] disabled (build with -DHYDROGEN_ENABLE_STATS=1)\n");
+#endif
+}
+
+} // namespace
+
+int main() {
+    benchFills();
+    bool easingOk = benchEasing();
+    benchAnimator();
+    benchTextWidth();
+    benchFonts();
+    setupDemo();
+    benchFrameRate();
+    benchGovernor();
+    unsigned long allocations = benchAllocations();
+    benchVirtualList();
+    bool longListOk = benchLongList();
+    benchListLayout();
+    benchNavigation();
+    benchLogger();
+    benchInput();
+    bool inputClockOk = benchInputClock();
+    benchArena();
+    benchWidgetTree();
+    benchStaticMenu();
+    benchAsyncFlush();
+    bool tilesOk = benchTileRenderer();
+    bool displayListOk = benchDisplayList();
+    benchFrameDiff();
+    benchFrameStats();
+    return allocations == 0 && easingOk && tilesOk && inputClockOk && longListOk && displayListOk ? 0 : 1;
+}
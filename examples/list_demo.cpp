@@ -12,6 +12,15 @@ Hydrogen::List* menuList;
 unsigned long lastEncoderEvent = 0;
 const unsigned long ENCODER_INTERVAL = 1000; // 每 1000ms 模拟一次旋转
 
+// 接入真实编码器时，在中断里投递事件即可，不需要在 loop() 中轮询：
+//   attachInterrupt(digitalPinToInterrupt(ENC_A), onEncoderEdge, FALLING);
+// 事件在下一次 App.update() 开始时交给列表处理 (List::handleEvent)
+void onEncoderEdge() {
+    // 示例引脚：B 相电平决定旋转方向
+    int delta = digitalRead(3) ? 1 : -1;
+    Hydrogen::App.postEvent(Hydrogen::InputEvent::encoder(delta));
+}
+
 void setup() {
     // 部署框架
     Hydrogen::deploy(u8g2);
@@ -45,10 +54,12 @@ void loop() {
         lastEncoderEvent = millis();
         
         // 模拟 "下一步" 动作 (顺时针旋转)
-        menuList->next();
+        Hydrogen::App.postEvent(Hydrogen::InputEvent::encoder(1));
         
         // 可选: 打印调试信息
         // Serial.print("Selected: ");
         // Serial.println(menuList->getSelectedItem().c_str());
+        // Serial.print("Input latency p99 (us): ");
+        // Serial.println(Hydrogen::App.getInputLatency().percentile(99));
     }
 }
@@ -12,11 +12,24 @@
 #include "hal/hal.h"
 #include "core/graphics.h"
 #include "core/app.h"
+#include "core/format.h"
+#include "core/display_list.h"
+#include "core/stats.h"
+#include "core/tile_renderer.h"
 #include "ui/widget.h"
 #include "ui/list.h"
+#include "ui/static_menu.h"
 #include "ui/fps_counter.h"
 
 // 平台适配器
+// 内存帧缓冲适配层不依赖任何第三方库，始终可用
+#include "hal/hal_framebuffer.h"
+
+// 主机端可用工作线程模拟异步传输 (需要 std::thread，以 HYDROGEN_HOST_THREADS=1 编译时才包含)
+#if HYDROGEN_HOST_THREADS
+#include "hal/hal_threaded.h"
+#endif
+
 // 如果检测到 U8g2 库，则自动包含 U8g2 适配层
 // U8G2LIB_HH 是 U8g2lib.h 中的包含保护宏
 #if defined(U8G2_LIB_H) || defined(U8X8_LIB_H) || defined(U8G2LIB_HH)
@@ -0,0 +1,156 @@
+#include "animator.h"
+
+namespace Hydrogen {
+
+// 缓动曲线查找表：32 段、33 个采样点，数值按 2^14 (16384 = 1.0) 缩放
+// 采样点之间线性插值。由 t -> f(t) 的解析式离线生成：
+//   EaseIn    t^3
+//   EaseOut   1 - (1-t)^3
+//   EaseInOut 4t^3 (t < 0.5)，1 - (2-2t)^3 / 2 (t >= 0.5)
+//   Back      1 + 2.70158 (t-1)^3 + 1.70158 (t-1)^2
+//   Bounce    easeOutBounce (Robert Penner)
+static const int CURVE_SEGMENTS = 32;
+static const int CURVE_ONE = 16384;
+
+static const int16_t CURVE_TABLES[5][CURVE_SEGMENTS + 1] = {
+    { // EaseIn
+            0,     0,     4,    14,    32,    62,   108,   172,   256,   364,   500,
+          666,   864,  1098,  1372,  1688,  2048,  2456,  2916,  3430,  4000,  4630,
+         5324,  6084,  6912,  7812,  8788,  9842, 10976, 12194, 13500, 14896, 16384,
+    },
+    { // EaseOut
+            0,  1488,  2884,  4190,  5408,  6542,  7596,  8572,  9472, 10300, 11060,
+        11754, 12384, 12954, 13468, 13928, 14336, 14696, 15012, 15286, 15520, 15718,
+        15884, 16020, 16128, 16212, 16276, 16322, 16352, 16370, 16380, 16384, 16384,
+    },
+    { // EaseInOut
+            0,     2,    16,    54,   128,   250,   432,   686,  1024,  1458,  2000,
+         2662,  3456,  4394,  5488,  6750,  8192,  9634, 10896, 11990, 12928, 13722,
+        14384, 14926, 15360, 15698, 15952, 16134, 16256, 16330, 16368, 16382, 16384,
+    },
+    { // Back
+            0,  2306,  4415,  6336,  8076,  9644, 11047, 12294, 13392, 14351, 15178,
+        15881, 16468, 16947, 17327, 17616, 17821, 17951, 18014, 18017, 17970, 17880,
+        17756, 17605, 17435, 17255, 17072, 16896, 16733, 16593, 16482, 16410, 16384,
+    },
+    { // Bounce
+            0,   121,   484,  1089,  1936,  3025,  4356,  5929,  7744,  9801, 12100,
+        14641, 15888, 14689, 13732, 13017, 12544, 12313, 12324, 12577, 13072, 13809,
+        14788, 16009, 15936, 15529, 15364, 15441, 15760, 16321, 16164, 16153, 16384,
+    },
+};
+
+// 2^14 缩放的整数转换为 Scalar
+static Scalar fromCurveValue(int32_t c) {
+#ifdef HYDROGEN_FIXED_POINT
+    return Fixed::fromRaw(c * (Fixed::ONE / CURVE_ONE));
+#else
+    return c * (1.0f / CURVE_ONE);
+#endif
+}
+
+Scalar Animator::sample(Curve curve, uint16_t elapsed, uint16_t duration, Scalar from, Scalar to) {
+    int32_t c;
+    if (curve == Curve::Linear) {
+        c = (int32_t)((uint32_t)elapsed * CURVE_ONE / duration);
+    } else {
+        // 进度换算为 "段号.8 位小数"，在相邻两个采样点之间插值
+        const int16_t* table = CURVE_TABLES[(int)curve - 1];
+        uint32_t pos = (uint32_t)elapsed * (CURVE_SEGMENTS << 8) / duration;
+        int idx = (int)(pos >> 8);
+        int32_t frac = (int32_t)(pos & 0xFF);
+        c = table[idx] + (table[idx + 1] - table[idx]) * frac / 256;
+    }
+    return from + (to - from) * fromCurveValue(c);
+}
+
+void Animator::apply(const Tween& t, Scalar v) {
+    bool changed = false;
+    if (t.scalar) {
+        if (*t.scalar != v) {
+            *t.scalar = v;
+            changed = true;
+        }
+    } else {
+        int iv = scalarRound(v);
+        if (*t.integer != iv) {
+            *t.integer = iv;
+            changed = true;
+        }
+    }
+    if (changed && t.onChange) t.onChange(t.user);
+}
+
+int Animator::find(const void* value) const {
+    for (int i = 0; i < count; ++i) {
+        if (tweens[i].scalar == value || tweens[i].integer == value) return i;
+    }
+    return -1;
+}
+
+bool Animator::start(Scalar* scalar, int* integer, Scalar current, Scalar to, uint16_t durationMs, Curve curve,
+                     Callback onChange, void* user, Callback onDone) {
+    int i = find(scalar ? (const void*)scalar : (const void*)integer);
+
+    // 目标不变：让正在播放的补间继续
+    if (i >= 0 && tweens[i].to == to) return true;
+
+    Tween t = {scalar, integer, current, to, 0, durationMs, curve, onChange, onDone, user};
+    bool ok = true;
+    if (durationMs > 0 && current != to) {
+        if (i < 0) {
+            if (count < MAX_TWEENS) i = count++;
+            else ok = false;
+        }
+        if (i >= 0) {
+            tweens[i] = t;
+            return true;
+        }
+    } else if (i >= 0) {
+        tweens[i] = tweens[--count];
+    }
+
+    // 无需动画 (或补间池已满)：立即到位
+    apply(t, to);
+    if (onDone) onDone(user);
+    return ok;
+}
+
+bool Animator::animate(Scalar* value, Scalar to, uint16_t durationMs, Curve curve,
+                       Callback onChange, void* user, Callback onDone) {
+    return start(value, nullptr, *value, to, durationMs, curve, onChange, user, onDone);
+}
+
+bool Animator::animate(int* value, int to, uint16_t durationMs, Curve curve,
+                       Callback onChange, void* user, Callback onDone) {
+    return start(nullptr, value, Scalar(*value), Scalar(to), durationMs, curve, onChange, user, onDone);
+}
+
+void Animator::cancel(const void* value) {
+    int i = find(value);
+    if (i >= 0) tweens[i] = tweens[--count];
+}
+
+void Animator::update(uint16_t ms) {
+    // 结束回调在遍历完成后统一触发，回调中可以安全地启动新的补间
+    struct Done { Callback cb; void* user; };
+    Done done[MAX_TWEENS];
+    int doneCount = 0;
+
+    for (int i = 0; i < count;) {
+        Tween& t = tweens[i];
+        if ((uint32_t)t.elapsed + ms >= t.duration) {
+            apply(t, t.to);
+            if (t.onDone) done[doneCount++] = Done{t.onDone, t.user};
+            tweens[i] = tweens[--count]; // 用末尾的补间填补空位，保持数组紧凑
+            continue;
+        }
+        t.elapsed += ms;
+        apply(t, sample(t.curve, t.elapsed, t.duration, t.from, t.to));
+        ++i;
+    }
+
+    for (int i = 0; i < doneCount; ++i) done[i].cb(done[i].user);
+}
+
+} // namespace Hydrogen
@@ -0,0 +1,112 @@
+#pragma once
+#include "fixed.h"
+#include <stdint.h>
+
+namespace Hydrogen {
+
+/**
+ * @brief 缓动曲线
+ * 除 Linear 外均由预计算的查找表插值得到，运行时不需要 pow/sin 等浮点函数。
+ */
+enum class Curve : uint8_t {
+    Linear,     ///< 匀速
+    EaseIn,     ///< 三次方加速
+    EaseOut,    ///< 三次方减速
+    EaseInOut,  ///< 三次方先加速后减速
+    Back,       ///< 减速并略微越过终点后回弹 (最大约 110%)
+    Bounce,     ///< 到达终点后弹跳
+};
+
+/**
+ * @brief 补间动画调度器
+ *
+ * 持有固定容量的补间池，每个补间在给定时长内按曲线把一个 Scalar 或 int 属性
+ * 从当前值过渡到目标值。活动补间保存在紧凑数组中，update() 只遍历活动补间，
+ * 因此每步的开销与正在播放的动画数量成正比，与控件总数无关。
+ *
+ * 同一属性同时只有一个补间：对正在播放的属性再次调用 animate() 会从当前值
+ * 重新开始过渡到新目标；目标不变时保持原补间继续播放。
+ *
+ * @note 被补间的属性必须在补间结束或 cancel() 之前一直有效，
+ * 持有补间属性的对象应在析构时调用 cancel()。
+ */
+class Animator {
+public:
+    static const int MAX_TWEENS = 16; ///< 补间池容量
+
+    /**
+     * @brief 补间回调
+     * @param user animate() 时传入的用户数据 (通常为控件自身)
+     */
+    typedef void (*Callback)(void* user);
+
+private:
+    struct Tween {
+        Scalar* scalar;     ///< 目标属性 (二选一)
+        int* integer;
+        Scalar from;
+        Scalar to;
+        uint16_t elapsed;   ///< 已播放时长 (毫秒)
+        uint16_t duration;  ///< 总时长 (毫秒)
+        Curve curve;
+        Callback onChange;  ///< 属性值每次变化后调用
+        Callback onDone;    ///< 补间结束时调用
+        void* user;
+    };
+
+    Tween tweens[MAX_TWEENS];
+    int count;
+
+    int find(const void* value) const;
+    bool start(Scalar* scalar, int* integer, Scalar current, Scalar to, uint16_t durationMs, Curve curve,
+               Callback onChange, void* user, Callback onDone);
+    static void apply(const Tween& t, Scalar v);
+    static Scalar sample(Curve curve, uint16_t elapsed, uint16_t duration, Scalar from, Scalar to);
+
+public:
+    Animator() : count(0) {}
+
+    /**
+     * @brief 启动 (或重定向) 一个 Scalar 属性的补间
+     * @param value 属性地址
+     * @param to 目标值
+     * @param durationMs 时长 (毫秒)，为 0 时立即到位
+     * @param curve 缓动曲线
+     * @param onChange 属性值每次变化后调用，可为 nullptr (其中不要启动或取消补间)
+     * @param user 传给回调的用户数据
+     * @param onDone 补间结束时调用，可为 nullptr
+     * @return false 表示补间池已满，属性已直接设为目标值
+     */
+    bool animate(Scalar* value, Scalar to, uint16_t durationMs, Curve curve = Curve::EaseOut,
+                 Callback onChange = nullptr, void* user = nullptr, Callback onDone = nullptr);
+
+    /**
+     * @brief 启动 (或重定向) 一个 int 属性的补间，中间值四舍五入
+     */
+    bool animate(int* value, int to, uint16_t durationMs, Curve curve = Curve::EaseOut,
+                 Callback onChange = nullptr, void* user = nullptr, Callback onDone = nullptr);
+
+    /**
+     * @brief 停止属性上的补间，属性保持当前值，不触发回调
+     */
+    void cancel(const void* value);
+
+    /**
+     * @brief 属性上是否有正在播放的补间
+     */
+    bool isAnimating(const void* value) const { return find(value) >= 0; }
+
+    /**
+     * @brief 推进所有活动补间
+     * 由 Application 在每个逻辑步长调用。
+     * @param ms 经过的时间 (毫秒)
+     */
+    void update(uint16_t ms);
+
+    /**
+     * @brief 正在播放的补间数量
+     */
+    int getActiveCount() const { return count; }
+};
+
+} // namespace Hydrogen
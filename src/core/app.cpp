@@ -1,11 +1,37 @@
 #include "app.h"
+#include <stdlib.h>
 
 namespace Hydrogen {
 
 // 全局实例定义
 Application App;
 
-Application::Application() : _hal(nullptr), _graphics(nullptr) {}
+#if HYDROGEN_ENABLE_STATS
+namespace {
+
+/**
+ * @brief 按 1bpp 页布局 (每页 8 行) 估算刷新一块屏幕区域的字节数
+ */
+unsigned long pageBytes(const Rect& r) {
+    if (r.isEmpty()) return 0;
+    return (unsigned long)r.w * (((r.y + r.h - 1) >> 3) - (r.y >> 3) + 1);
+}
+
+} // namespace
+#endif
+
+Application::Application() : _hal(nullptr), _graphics(nullptr), _arena(nullptr), _frameCount(0), _skippedFrames(0),
+                             _lastMillis(0), _tickTime(0),
+                             _tickPending(false), _halfRateSkip(false), _inputHandler(nullptr), _inputUser(nullptr),
+                             _unshownCount(0), _flushing(false), _flushPolicy(FlushPolicy::Wait),
+                             _deferredFlushes(0), _flushingCount(0), _displayList(nullptr), _drawingFrame(nullptr),
+                             _unchangedFrames(0) {
+    _camera.setAnimator(&_animator);
+#if HYDROGEN_ENABLE_STATS
+    _clearUs = 0;
+    _halMeasures = 0;
+#endif
+}
 
 Application::~Application() {
     if (_graphics) delete _graphics;
@@ -20,35 +46,385 @@ void Application::begin(HAL* hal) {
     _hal = hal;
     if (_hal) {
         _hal->init(); // 初始化硬件
+        delete _graphics; // 重新 begin() 时替换旧的图形上下文
         _graphics = new Graphics(_hal); // 创建图形上下文
+#if HYDROGEN_ENABLE_STATS
+        _graphics->setStats(&_stats);
+        _halMeasures = 0;
+#endif
+        _damage.setScreen(_hal->getWidth(), _hal->getHeight());
+        _unflushed.setScreen(_hal->getWidth(), _hal->getHeight());
+        _unflushed.reset();
+        _flushing = false;
+        if (_displayList) _displayList->invalidate(); // 新的屏幕内容未知
+        _lastMillis = _hal->getMillis();
+        _tickTime = 0;
+        _tickPending = false;
     }
 }
 
 void Application::add(Widget* widget) {
     _widgets.push_back(widget);
+    _damage.invalidateAll();
+}
+
+void Application::clear() {
+    for (auto w : _widgets) {
+        delete w;
+    }
+    _widgets.clear();
+    _damage.invalidateAll();
 }
 
-void Application::update() {
-    if (!_hal || !_graphics) return;
+void Application::invalidate(const Rect& r) {
+    int camX = _graphics ? _graphics->getCamX() : 0;
+    int camY = _graphics ? _graphics->getCamY() : 0;
+    _damage.add(Rect{r.x - camX, r.y - camY, r.w, r.h});
+}
 
-    // 1. 更新相机位置（平滑滚动核心）
-    _camera.update();
+bool Application::skips(const Widget* w) const {
+    return _governor.getLevel() >= 1 && w->isDecorative();
+}
+
+void Application::drawTree(Widget* w) {
+    if (!w->isVisible() || skips(w)) return;
+    // 当前原点为父控件的左上角，bounds 与裁剪区直接比较即可。
+    // 根控件不剔除：List、FPSCounter 等按屏幕位置绘制，bounds 不代表内容所在的世界坐标；
+    // 边界为空的控件 (自适应宽度的 Label) 无法判断，也总是绘制
+    Rect r = w->getBounds();
+    if (w->getParent() && !r.isEmpty() && !_graphics->isVisible(r)) return;
+#if HYDROGEN_ENABLE_STATS
+    unsigned long startUs = _hal->getMicros();
+    w->draw(*_graphics);
+    _stats.recordWidget(w, r, _hal->getMicros() - startUs);
+#else
+    w->draw(*_graphics);
+#endif
+
+    const std::vector<Widget*>& children = w->getChildren();
+    if (children.empty()) return;
+    _graphics->translate(r.x, r.y);
+    for (auto child : children) {
+        drawTree(child);
+    }
+    _graphics->translate(-r.x, -r.y);
+}
+
+void Application::drawWidgets() {
+    for (auto w : _widgets) {
+        drawTree(w);
+    }
+}
+
+void Application::updateTree(Widget* w) {
+    if (skips(w)) return;
+    w->update();
+    for (auto child : w->getChildren()) {
+        updateTree(child);
+    }
+}
+
+bool Application::isTreeAnimating(const Widget* w) const {
+    if (skips(w)) return false;
+    if (w->isAnimating()) return true;
+    for (auto child : w->getChildren()) {
+        if (isTreeAnimating(child)) return true;
+    }
+    return false;
+}
+
+bool Application::dispatchTo(Widget* w, const InputEvent& e) {
+    if (!w->isVisible() || skips(w)) return false;
+    // 子控件画在父控件之上，先交给子控件 (后添加的优先)
+    const std::vector<Widget*>& children = w->getChildren();
+    for (size_t i = children.size(); i-- > 0;) {
+        if (dispatchTo(children[i], e)) return true;
+    }
+    return w->handleEvent(e);
+}
+
+bool Application::postEvent(const InputEvent& e) {
+    InputEvent stamped = e;
+    stamped.stampUs = _hal ? _hal->getMicros() : 0;
+    return _input.push(stamped);
+}
+
+bool Application::dispatchInput() {
+    InputEvent e;
+    bool any = false;
+    while (_input.pop(e)) {
+        any = true;
+        // 记下投递时间，等显示出结果的那一帧刷新完成后计算延迟 (超出的只统计最早的几个)
+        if (_unshownCount < MAX_UNSHOWN_INPUT) _unshownInput[_unshownCount++] = e.stampUs;
+
+        if (_inputHandler && _inputHandler(e, _inputUser)) continue;
+        // 后添加的控件在上层，优先处理
+        for (size_t i = _widgets.size(); i-- > 0;) {
+            if (dispatchTo(_widgets[i], e)) break;
+        }
+    }
+    return any;
+}
+
+void Application::tick() {
+    // 推进所有活动补间（相机平滑滚动、控件动画）
+    _animator.update(HYDROGEN_TICK_MS);
+
+    // 更新整棵控件树的逻辑（如动画状态），控件在外观变化时上报脏区域
+    for (auto w : _widgets) {
+        updateTree(w);
+    }
+}
+
+void Application::reportSkipped(unsigned long startUs) {
+    // 降级期间没有绘制的帧也算作余量，否则画面静止后画质永远无法恢复
+    if (_governor.getLevel() > 0 && _governor.report(_hal->getMicros() - startUs, 0, 0)) {
+        applyQuality();
+    }
+}
+
+void Application::applyQuality() {
+    _graphics->setLowDetail(_governor.getLevel() >= 2);
+    // 装饰性控件的显隐和图元的画法都变了，整屏重绘一次
+    _damage.invalidateAll();
+}
+
+bool Application::update() {
+    if (!_hal || !_graphics) return false;
+
+    unsigned long startUs = _hal->getMicros();
+
+    // 上一帧的异步传输已经结束
+    if (_flushing && _hal->isFlushDone()) finishFlush();
+
+    // 0. 处理中断投递的输入事件
+    bool hadInput = dispatchInput();
+
+    // 1. 按固定步长推进逻辑时钟
+    // 无符号减法在 millis() 回绕时依然正确
+    unsigned long now = _hal->getMillis();
+    // 长时间没有调用时经过的时间本来就会被截断，先截断再转为有符号数
+    const unsigned long maxTime = (unsigned long)MAX_TICKS_PER_UPDATE * HYDROGEN_TICK_MS;
+    unsigned long elapsed = now - _lastMillis;
+    _tickTime += (long)(elapsed < maxTime ? elapsed : maxTime);
+    _lastMillis = now;
+    // 有新输入时把下一个步长提前到现在执行，控件立即响应并在本次调用中出帧，而不是等到下一个步长。
+    // 提前的时间记为借用 (_tickTime 为负)，之后的调用从经过的时间中偿还；上一次借用还清之前不再借用，
+    // 逻辑时钟最多领先实际时间一个步长，动画速度不受输入频率影响。
+    // 借用期间到达的输入在借用还清后立即执行下一个步长
+    if (hadInput) _tickPending = true;
+    if (_tickPending && _tickTime >= 0 && _tickTime < HYDROGEN_TICK_MS) {
+        _tickTime -= HYDROGEN_TICK_MS;
+        _tickPending = false;
+        tick();
+    }
+    if (_tickTime > (long)maxTime) _tickTime = (long)maxTime;
+    while (_tickTime >= HYDROGEN_TICK_MS) {
+        _tickTime -= HYDROGEN_TICK_MS;
+        _tickPending = false;
+        tick();
+    }
 
     // 2. 将相机位置应用到图形上下文
     // 这会影响后续所有的绘图操作（实现全局坐标系）
-    _graphics->setCamera(_camera.getX(), _camera.getY());
+    // 相机移动时整个视口的内容都发生了平移，需要整屏重绘
+    int camX = _camera.getX();
+    int camY = _camera.getY();
+    if (_governor.getLevel() >= 2 && _camera.isMoving() &&
+        abs(camX - _graphics->getCamX()) < CAMERA_COALESCE_STEP &&
+        abs(camY - _graphics->getCamY()) < CAMERA_COALESCE_STEP) {
+        // 降级时合并相机的小步移动，减少整屏重绘的次数
+        camX = _graphics->getCamX();
+        camY = _graphics->getCamY();
+    }
+    if (camX != _graphics->getCamX() || camY != _graphics->getCamY()) {
+        _damage.invalidateAll();
+    }
+    _graphics->setCamera(camX, camY);
 
-    // 3. 清除屏幕
-    _hal->clear();
+    // 画面与上一帧完全相同：不清屏、不重绘、不占用总线
+    if (_damage.isEmpty()) {
+        // 传输忙时推迟送出的一帧，等总线空闲后送出
+        if (!_unflushed.isEmpty()) submitFlush();
+        _skippedFrames++;
+        // 事件处理完后界面已静止：它们没有可显示的结果，不计入延迟
+        if (_unshownCount > 0 && isIdle()) _unshownCount = 0;
+        reportSkipped(startUs);
+        return false;
+    }
 
-    // 4. 更新并绘制所有根控件
-    for (auto w : _widgets) {
-        w->update(); // 更新控件逻辑（如动画状态）
-        w->draw(*_graphics); // 绘制控件
+    // 最低画质：隔帧刷新，脏区域累积到下一帧一起处理 (有待显示的输入时不跳过)
+    if (_governor.getLevel() >= 3 && _unshownCount == 0) {
+        _halfRateSkip = !_halfRateSkip;
+        if (_halfRateSkip) {
+            reportSkipped(startUs);
+            return false;
+        }
+    }
+
+#if HYDROGEN_ENABLE_STATS
+    _stats.beginFrame(startUs);
+    _clearUs = 0;
+#endif
+
+    // 取出本帧的脏区域。绘制过程中新上报的区域留给下一帧处理
+    DamageTracker frame = _damage;
+    _damage.reset();
+    unsigned long drawUs = _hal->getMicros();
+    bool changed = draw(frame);
+    unsigned long flushUs = _hal->getMicros();
+    if (changed) {
+        flush(frame);
+    } else {
+        // 屏幕内容不变，只送出之前推迟的区域
+        _unchangedFrames++;
+        if (!_unflushed.isEmpty()) submitFlush();
+        if (_unshownCount > 0 && isIdle()) _unshownCount = 0;
+    }
+    unsigned long endUs = _hal->getMicros();
+
+    if (changed) _frameCount++;
+#if HYDROGEN_ENABLE_STATS
+    _stats.addPhase(FrameStats::Phase::Update, drawUs - startUs);
+    _stats.addPhase(FrameStats::Phase::Clear, _clearUs);
+    _stats.addPhase(FrameStats::Phase::Draw, flushUs - drawUs - _clearUs);
+    _stats.addPhase(FrameStats::Phase::Flush, endUs - flushUs);
+    unsigned long measures = _graphics->getTextCache().getHalMeasures();
+    _stats.count(FrameStats::Counter::StrWidth, measures - _halMeasures);
+    _halMeasures = measures;
+    _stats.endFrame(endUs);
+#endif
+    if (_governor.report(drawUs - startUs, flushUs - drawUs, endUs - flushUs)) {
+        applyQuality();
+    }
+    return changed;
+}
+
+bool Application::draw(const DamageTracker& frame) {
+    Rect area = frame.isFull() ? Rect{0, 0, _hal->getWidth(), _hal->getHeight()} : frame.getBounds();
+
+    // 3. 设置了显示列表时先录制：命令流与上一帧相同说明屏幕上已是这些像素，无需清除和重绘
+    // 连续未命中时列表处于旁路期，直接绘制
+    if (_displayList && _displayList->shouldRecord()) {
+        _drawingFrame = &frame;
+        _graphics->setClip(area);
+        _graphics->beginRecording(_displayList, clearOnOverflow, this);
+        drawWidgets();
+        bool overflowed = !_graphics->isRecording(); // 溢出时已清除、回放，其余控件已直接绘制
+        _graphics->endRecording();
+        _graphics->resetClip();
+        _drawingFrame = nullptr;
+        if (overflowed) return true;
+        if (_displayList->matchesPrevious()) return false;
+        clearDamage(frame);
+        _graphics->replay(*_displayList, area);
+        return true;
+    }
+
+    clearDamage(frame);
+    _graphics->setClip(area);
+    drawWidgets();
+    _graphics->resetClip();
+    return true;
+}
+
+void Application::clearOnOverflow(void* app) {
+    Application* self = static_cast<Application*>(app);
+    self->clearDamage(*self->_drawingFrame);
+}
+
+void Application::clearDamage(const DamageTracker& frame) {
+#if HYDROGEN_ENABLE_STATS
+    unsigned long clearStartUs = _hal->getMicros();
+#endif
+    if (frame.isFull()) {
+        // 3a. 整屏重绘
+        HYDROGEN_COUNT(&_stats, Fill, 1);
+        HYDROGEN_COUNT(&_stats, Pixels, (unsigned long)_hal->getWidth() * _hal->getHeight());
+        _hal->clear();
+    } else {
+        // 3b. 局部重绘：清除各脏矩形，在其包围盒内重绘所有控件
+        // 包围盒内未被清除的像素会以相同内容重绘一次，结果不变
+        for (int i = 0; i < frame.getCount(); ++i) {
+            const Rect& r = frame.get(i);
+            HYDROGEN_COUNT(&_stats, Fill, 1);
+            HYDROGEN_COUNT(&_stats, Pixels, (unsigned long)r.w * r.h);
+            _hal->fillRect(r.x, r.y, r.w, r.h, 0);
+        }
+    }
+#if HYDROGEN_ENABLE_STATS
+    _clearUs = _hal->getMicros() - clearStartUs;
+#endif
+}
+
+void Application::flush(const DamageTracker& frame) {
+    // 4. 本帧并入尚未送出的区域 (推迟送出时会累积多帧)
+    if (frame.isFull()) {
+        _unflushed.invalidateAll();
+    } else {
+        for (int i = 0; i < frame.getCount(); ++i) _unflushed.add(frame.get(i));
+    }
+    if (!submitFlush()) _deferredFlushes++;
+}
+
+bool Application::submitFlush() {
+    if (_flushing) {
+        if (!_hal->isFlushDone()) {
+            if (_flushPolicy == FlushPolicy::Skip) return false;
+            _hal->waitFlush();
+        }
+        finishFlush();
+    }
+
+    // 4a. 异步刷新：交换缓冲区后立即返回，输入延迟等传输完成后再计入
+    Rect r = _unflushed.isFull() ? Rect{0, 0, _hal->getWidth(), _hal->getHeight()} : _unflushed.getBounds();
+    if (_hal->beginFlush(r.x, r.y, r.w, r.h)) {
+        HYDROGEN_COUNT(&_stats, Bytes, pageBytes(r));
+        _flushing = true;
+        for (int i = 0; i < _unshownCount; ++i) _flushingInput[i] = _unshownInput[i];
+        _flushingCount = _unshownCount;
+        _unshownCount = 0;
+        _unflushed.reset();
+        return true;
+    }
+
+    // 4b. 同步刷新：整屏失效时整屏推送，否则只推送脏矩形覆盖的区域
+    if (_unflushed.isFull()) {
+        HYDROGEN_COUNT(&_stats, Bytes, pageBytes(r));
+        _hal->update();
+    } else {
+        for (int i = 0; i < _unflushed.getCount(); ++i) {
+            const Rect& d = _unflushed.get(i);
+            HYDROGEN_COUNT(&_stats, Bytes, pageBytes(d));
+            _hal->updateRegion(d.x, d.y, d.w, d.h);
+        }
     }
+    _unflushed.reset();
+    recordLatency(_unshownInput, _unshownCount);
+    _unshownCount = 0;
+    return true;
+}
+
+void Application::finishFlush() {
+    _flushing = false;
+    recordLatency(_flushingInput, _flushingCount);
+    _flushingCount = 0;
+}
 
-    // 5. 刷新屏幕缓冲区
-    _hal->update();
+void Application::recordLatency(const unsigned long* stamps, int count) {
+    unsigned long now = _hal->getMicros();
+    for (int i = 0; i < count; ++i) _inputLatency.record(now - stamps[i]);
+}
+
+bool Application::isIdle() const {
+    if (_animator.getActiveCount() > 0 || _camera.isMoving() || !_damage.isEmpty() || !_input.isEmpty() ||
+        !_unflushed.isEmpty() || _flushing) {
+        return false;
+    }
+    for (auto w : _widgets) {
+        if (isTreeAnimating(w)) return false;
+    }
+    return true;
 }
 
 } // namespace Hydrogen
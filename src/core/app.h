@@ -1,12 +1,27 @@
 #pragma once
 #include "../hal/hal.h"
 #include "graphics.h"
+#include "animator.h"
 #include "camera.h"
+#include "damage.h"
+#include "governor.h"
+#include "timing.h"
+#include "input.h"
+#include "arena.h"
+#include "stats.h"
 #include "../ui/widget.h"
 #include <vector>
 
 namespace Hydrogen {
 
+/**
+ * @brief 异步刷新时，上一帧仍在传输时的处理方式
+ */
+enum class FlushPolicy : uint8_t {
+    Wait, ///< 等待传输完成后立即送出本帧
+    Skip  ///< 不等待：本帧留在绘制缓冲区，总线空闲后与之后的变化一起送出
+};
+
 /**
  * @brief 应用程序核心管理类
  *
@@ -14,14 +29,87 @@ namespace Hydrogen {
  * 1. 管理硬件抽象层 (HAL)
  * 2. 维护全局图形上下文 (Graphics)
  * 3. 管理 UI 控件树
- * 4. 驱动主循环和全局相机系统
+ * 4. 驱动主循环、补间调度器和全局相机系统
+ * 5. 跟踪脏区域，只重绘并刷新发生变化的部分
+ * 6. 接收中断投递的输入事件，并统计输入到画面刷新的延迟
+ * 7. HAL 支持异步刷新 (HAL::beginFlush) 时，渲染下一帧与屏幕传输同时进行
+ * 8. 设置了显示列表时先录制一帧，命令流与上一帧相同则跳过光栅化
+ * 9. 以 HYDROGEN_ENABLE_STATS=1 编译时收集逐帧统计 (getStats)
  */
 class Application {
+public:
+    /**
+     * @brief 全局输入处理函数，先于控件收到事件
+     * @return 事件是否已被处理 (返回 true 时不再交给控件)
+     */
+    typedef bool (*InputHandler)(const InputEvent& e, void* user);
+
 private:
     HAL* _hal;
     Graphics* _graphics;
+    Animator _animator;
     Camera _camera;
     std::vector<Widget*> _widgets;
+    WidgetArena* _arena;
+    DamageTracker _damage;
+    FrameGovernor _governor;
+    unsigned long _frameCount;    ///< 实际绘制并刷新的帧数
+    unsigned long _skippedFrames; ///< 因画面无变化而跳过的帧数
+    unsigned long _lastMillis;    ///< 上一次 update() 时的系统时间
+    long _tickTime;               ///< 尚未消耗的时间 (不足一个步长的余量)；为负时是输入提前借用、尚未偿还的时间
+    bool _tickPending;            ///< 有输入还没等到逻辑步长 (借用的时间尚未还清)
+    bool _halfRateSkip;           ///< 隔帧刷新时，本帧是否跳过
+
+    InputQueue _input;
+    InputHandler _inputHandler;
+    void* _inputUser;
+    LatencyStats _inputLatency;
+    static const int MAX_UNSHOWN_INPUT = 8;
+    unsigned long _unshownInput[MAX_UNSHOWN_INPUT]; ///< 已处理、尚未显示到屏幕上的事件的投递时间
+    int _unshownCount;
+
+    // 异步刷新
+    DamageTracker _unflushed;     ///< 已绘制、尚未送出的区域
+    bool _flushing;               ///< 有一次 beginFlush() 开始的传输尚未确认完成 (下一次 update() 确认)
+    FlushPolicy _flushPolicy;
+    unsigned long _deferredFlushes; ///< 因上一帧仍在传输而推迟送出的次数
+    unsigned long _flushingInput[MAX_UNSHOWN_INPUT]; ///< 正在传输的一帧所显示的事件的投递时间
+    int _flushingCount;
+
+    DisplayList* _displayList;         ///< 录制帧的显示列表，nullptr 表示直接绘制
+    const DamageTracker* _drawingFrame; ///< 正在绘制的一帧的脏区域 (列表溢出时据此清除)
+    unsigned long _unchangedFrames;    ///< 命令流与上一帧相同而跳过光栅化的帧数
+
+#if HYDROGEN_ENABLE_STATS
+    FrameStats _stats;
+    unsigned long _clearUs;            ///< 本帧清除脏区域的耗时
+    unsigned long _halMeasures;        ///< 上一帧结束时文本宽度缓存调用 HAL 测量的次数
+#endif
+
+    /// 单次 update() 最多补跑的逻辑步长数。渲染长时间卡顿后超出部分直接丢弃，
+    /// 避免为追赶进度而越跑越慢
+    static const int MAX_TICKS_PER_UPDATE = 8;
+
+    /// 画质降到 2 级后，相机至少移动这么多像素才重绘
+    static const int CAMERA_COALESCE_STEP = 4;
+
+    bool skips(const Widget* w) const;
+    bool dispatchTo(Widget* w, const InputEvent& e);
+    void updateTree(Widget* w);
+    void drawTree(Widget* w);
+    bool isTreeAnimating(const Widget* w) const;
+    bool dispatchInput();
+    void tick();
+    void reportSkipped(unsigned long startUs);
+    void applyQuality();
+    void drawWidgets();
+    bool draw(const DamageTracker& frame);
+    void clearDamage(const DamageTracker& frame);
+    static void clearOnOverflow(void* app);
+    void flush(const DamageTracker& frame);
+    bool submitFlush();
+    void finishFlush();
+    void recordLatency(const unsigned long* stamps, int count);
 
 public:
     Application();
@@ -35,22 +123,178 @@ public:
 
     /**
      * @brief 添加根级控件
+     * 根控件及其子控件按树遍历：子控件在父控件之后更新和绘制。
+     * 不可见的控件、完全在裁剪区外的子控件 (根控件自身不按边界剔除) 连同子树一起跳过绘制。
      * @param widget 控件指针 (框架接管其生命周期)
      */
     void add(Widget* widget);
 
+    /**
+     * @brief 删除所有根级控件 (连同它们的子控件、列表项)，用于拆除整个界面
+     */
+    void clear();
+
+    /**
+     * @brief 设置控件内存池
+     * 之后 make() 以及 List 自动创建的列表项都在内存池中分配。
+     * @param arena 内存池 (不接管其生命周期)，nullptr 表示使用堆
+     */
+    void setArena(WidgetArena* arena) { _arena = arena; }
+    WidgetArena* getArena() const { return _arena; }
+
+    /**
+     * @brief 构造控件：设置了内存池时在内存池中分配，内存池已满时改用 new (计入 WidgetArena::getFailures)
+     * 返回的控件与 new 出来的一样交给 add()/List::addItem() 管理，照常用 delete 释放。
+     */
+    template <class T, class... Args>
+    T* make(Args&&... args) {
+        return makeWidget<T>(_arena, std::forward<Args>(args)...);
+    }
+
     /**
      * @brief 主循环更新
      * 需要在主程序的 loop() 中调用。
-     * 负责：更新相机 -> 清屏 -> 更新控件逻辑 -> 绘制控件 -> 刷新屏幕
+     * 负责：分发输入事件 -> 推进逻辑时钟 (补间动画与控件) -> 清除脏区域 -> 绘制控件 -> 刷新脏区域
+     *
+     * HAL 支持异步刷新时，刷新只是开始传输并立即返回，下一次 update() 在另一块缓冲区上绘制；
+     * 到需要送出新的一帧时上一帧仍未传完，按 FlushPolicy 等待或推迟。
+     *
+     * 补间调度器与控件的 update() 按固定步长 HYDROGEN_TICK_MS 运行，次数由距上次调用
+     * 经过的时间决定，与调用频率无关：主循环降低渲染频率时动画速度保持不变。
+     *
+     * 相机移动时整屏重绘；否则只清除、重绘并推送控件上报的脏区域。
+     * 没有任何脏区域时直接返回，不清屏、不绘制、不刷新。
+     * 每绘制一帧都会把各阶段耗时上报给 FrameGovernor，持续超出预算时自动降低画质。
+     *
+     * @return 本次调用是否产生了新的一帧 (false 表示画面无变化，已跳过)
+     */
+    bool update();
+
+    /**
+     * @brief 设置异步刷新时上一帧仍在传输的处理方式 (默认 FlushPolicy::Wait)
+     * Skip 适合主循环还要处理其他任务的场合：update() 不会阻塞在总线上。
+     */
+    void setFlushPolicy(FlushPolicy policy) { _flushPolicy = policy; }
+    FlushPolicy getFlushPolicy() const { return _flushPolicy; }
+
+    /**
+     * @brief 因上一帧仍在传输而推迟送出的次数 (FlushPolicy::Skip)
+     */
+    unsigned long getDeferredFlushes() const { return _deferredFlushes; }
+
+    /**
+     * @brief 设置显示列表
+     * 之后每帧先把控件树录制到列表中 (录制区域为本帧的脏区域包围盒)：命令流的哈希与上一帧相同时
+     * 屏幕上已经是这些像素，不清屏、不光栅化、也不刷新；否则清除脏区域后回放列表。
+     * 列表溢出时清除脏区域、回放已录制的部分，其余控件直接绘制；可用 DisplayList::getHighWater() 确定容量。
+     * 连续多帧未命中时列表暂停录制、直接绘制，见 DisplayList::setAdaptive()。
+     * @param list 显示列表 (不接管其生命周期)，nullptr 表示直接绘制
+     */
+    void setDisplayList(DisplayList* list) {
+        _displayList = list;
+        if (list) list->invalidate();
+    }
+    DisplayList* getDisplayList() const { return _displayList; }
+
+    /**
+     * @brief 有脏区域、但录制的命令流与上一帧相同而跳过光栅化的帧数
+     */
+    unsigned long getUnchangedFrames() const { return _unchangedFrames; }
+
+#if HYDROGEN_ENABLE_STATS
+    /**
+     * @brief 逐帧统计 (各阶段耗时、HAL 调用次数、最耗时的控件)，参见 FrameStats
      */
-    void update();
+    FrameStats& getStats() { return _stats; }
+    const FrameStats& getStats() const { return _stats; }
+#endif
+
+    /**
+     * @brief 投递输入事件 (可在中断或另一个任务中调用，同一时刻只能有一个生产者)
+     * 事件记下当前时间后进入无锁队列，在下一次 update() 开始时分发给 InputHandler 与根控件。
+     * 该次 update() 会立即运行一个逻辑步长并出帧 (不会被隔帧刷新推迟)。提前运行的步长从之后经过的时间中扣除，
+     * 逻辑时钟最多领先实际时间一个步长；上一次提前的时间尚未扣完时，等到扣完再运行。
+     * @return 队列已满时返回 false，事件被丢弃
+     */
+    bool postEvent(const InputEvent& e);
+
+    /**
+     * @brief 设置全局输入处理函数
+     */
+    void setInputHandler(InputHandler handler, void* user = nullptr) {
+        _inputHandler = handler;
+        _inputUser = user;
+    }
+
+    /**
+     * @brief 输入延迟统计：事件投递到显示其结果的那次 HAL 刷新完成之间的时间
+     * 处理后没有引起任何重绘的事件不计入。异步刷新在 update() 发现传输已完成时计入。
+     */
+    const LatencyStats& getInputLatency() const { return _inputLatency; }
+    void resetInputLatency() { _inputLatency.reset(); }
+
+    /**
+     * @brief 因队列已满被丢弃的输入事件数
+     */
+    unsigned long getDroppedEvents() const { return _input.getDropped(); }
+
+    /**
+     * @brief 界面是否处于静止状态
+     * 相机已停止、没有控件在播放动画、没有待处理的输入事件、也没有待重绘或待送出的区域时返回 true。
+     * 主循环可据此降低调用频率或让 MCU 休眠，把时间留给其他任务。
+     */
+    bool isIdle() const;
+
+    /**
+     * @brief 已绘制的帧数
+     */
+    unsigned long getFrameCount() const { return _frameCount; }
+
+    /**
+     * @brief 因画面无变化而跳过的帧数
+     */
+    unsigned long getSkippedFrames() const { return _skippedFrames; }
+
+    /**
+     * @brief 标记一个区域需要重绘
+     * @param r 世界坐标下的矩形 (会按当前相机位置换算为屏幕坐标)
+     */
+    void invalidate(const Rect& r);
+
+    /**
+     * @brief 标记一个屏幕区域需要重绘
+     * 用于不随相机移动的 HUD 元素 (如 FPSCounter、滚动条)。
+     * @param r 屏幕坐标下的矩形
+     */
+    void invalidateScreen(const Rect& r) { _damage.add(r); }
+
+    /**
+     * @brief 标记整屏需要重绘
+     */
+    void invalidateAll() { _damage.invalidateAll(); }
+
+    /**
+     * @brief 获取硬件抽象层实例
+     */
+    HAL* getHAL() { return _hal; }
 
     /**
      * @brief 获取全局图形上下文
      */
     Graphics* getGraphics() { return _graphics; }
 
+    /**
+     * @brief 获取全局补间调度器
+     * 控件通过它播放属性动画，参见 Animator::animate()
+     */
+    Animator& getAnimator() { return _animator; }
+
+    /**
+     * @brief 获取帧预算调节器
+     * 可设置帧预算、限制降级等级，或读取当前画质等级与超时统计
+     */
+    FrameGovernor& getGovernor() { return _governor; }
+
     /**
      * @brief 获取全局相机对象
      * 可通过此对象控制屏幕滚动
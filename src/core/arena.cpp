@@ -0,0 +1,103 @@
+#include "arena.h"
+
+namespace Hydrogen {
+
+WidgetArena* WidgetArena::arenas = nullptr;
+
+WidgetArena::WidgetArena(void* buffer, size_t size)
+    : base((uint8_t*)buffer), capacity(size), top(0), highWater(0), last(nullptr), liveCount(0), failures(0) {
+    // 调用者提供的内存未对齐时从下一个对齐位置开始使用
+    size_t skew = (size_t)((uintptr_t)base % ALIGN);
+    if (skew) {
+        size_t skip = ALIGN - skew;
+        base += skip;
+        capacity = capacity > skip ? capacity - skip : 0;
+    }
+    for (int i = 0; i < FREE_CLASSES; ++i) freeLists[i] = nullptr;
+    nextArena = arenas;
+    arenas = this;
+}
+
+WidgetArena::~WidgetArena() {
+    reset();
+    for (WidgetArena** a = &arenas; *a; a = &(*a)->nextArena) {
+        if (*a == this) {
+            *a = nextArena;
+            break;
+        }
+    }
+}
+
+void* WidgetArena::allocate(size_t size, size_t align, void (*destroy)(void*)) {
+    if (align > ALIGN) {
+        failures++;
+        return nullptr;
+    }
+    size_t rounded = size ? (size + ALIGN - 1) / ALIGN * ALIGN : ALIGN;
+    size_t cls = rounded / ALIGN;
+
+    Block* b;
+    if (cls < (size_t)FREE_CLASSES && freeLists[cls]) {
+        // 复用同样大小的空闲块
+        b = freeLists[cls];
+        freeLists[cls] = b->nextFree;
+    } else {
+        if (HEADER + rounded > capacity - top) {
+            failures++;
+            return nullptr;
+        }
+        b = (Block*)(base + top);
+        b->prev = last;
+        b->size = rounded;
+        last = b;
+        top += HEADER + rounded;
+        if (top > highWater) highWater = top;
+    }
+    b->destroy = destroy;
+    b->nextFree = nullptr;
+    liveCount++;
+    return (uint8_t*)b + HEADER;
+}
+
+bool WidgetArena::release(void* p) {
+    WidgetArena* a = arenas;
+    while (a && !a->owns(p)) a = a->nextArena;
+    if (!a) return false;
+
+    Block* b = (Block*)((uint8_t*)p - HEADER);
+    b->destroy = nullptr;
+    a->liveCount--;
+    if (b == a->last) {
+        // 最后分配的块直接退回
+        a->top = (uint8_t*)b - a->base;
+        a->last = b->prev;
+    } else {
+        size_t cls = b->size / ALIGN;
+        if (cls < (size_t)FREE_CLASSES) {
+            b->nextFree = a->freeLists[cls];
+            a->freeLists[cls] = b;
+        }
+        // 更大的块只能等到 reset() 时回收
+    }
+    return true;
+}
+
+void WidgetArena::reset() {
+    // 析构过程中会有块被 release 退回，因此每次都重新读取 top
+    for (size_t offset = 0; offset < top;) {
+        Block* b = (Block*)(base + offset);
+        offset += HEADER + b->size;
+        if (b->destroy) {
+            void (*destroy)(void*) = b->destroy;
+            b->destroy = nullptr;
+            liveCount--;
+            destroy((uint8_t*)b + HEADER);
+        }
+    }
+    top = 0;
+    last = nullptr;
+    liveCount = 0;
+    for (int i = 0; i < FREE_CLASSES; ++i) freeLists[i] = nullptr;
+}
+
+} // namespace Hydrogen
@@ -0,0 +1,151 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+#include <utility>
+
+namespace Hydrogen {
+
+/**
+ * @brief 控件内存池
+ *
+ * 在一块固定大小的内存上分配控件，避免长期运行的设备反复重建界面 (Wi-Fi 扫描结果、设置页)
+ * 后堆内存碎片化。分配按指针递增 (bump)；被 delete 的控件所在的块按大小挂到空闲链表上，
+ * 之后同样大小的控件 (通常是同一类型) 直接复用。
+ *
+ * 池中的控件仍然用 delete 释放 (App、List、父控件的析构都照常工作)：Widget 重载了
+ * operator delete，只运行析构函数并把块还给内存池。
+ *
+ * reset() 一次性回收整块内存 (包括空闲链表)，用于拆除整个界面。通常先用 Application::clear()
+ * 删除控件树，再调用 reset()。仍然存活的对象会按分配顺序被析构：先创建的容器 (如 List) 析构时
+ * 会正常删除后创建的列表项；但仍被内存池之外的容器持有的控件不能留到 reset()。
+ *
+ * @code
+ *   static StaticWidgetArena<4096> arena;
+ *   App.setArena(&arena);
+ *   Switch* sw = App.make<Switch>(0, 0, 128, 16, StaticText("Wi-Fi"));
+ * @endcode
+ */
+class WidgetArena {
+public:
+    /// 分配的对齐粒度
+    static const size_t ALIGN = sizeof(void*) * 2 > 8 ? sizeof(void*) * 2 : 8;
+
+private:
+    struct Block {
+        Block* prev;             ///< 上一个分配的块
+        Block* nextFree;         ///< 空闲链表中的下一块
+        void (*destroy)(void*);  ///< 对象的析构函数，nullptr 表示块空闲
+        size_t size;             ///< 对象区大小 (已对齐)
+    };
+    static const size_t HEADER = (sizeof(Block) + ALIGN - 1) / ALIGN * ALIGN;
+    static const int FREE_CLASSES = 32; ///< 按 ALIGN 分档回收的最大对象尺寸
+
+    uint8_t* base;
+    size_t capacity;
+    size_t top;          ///< 已分配到的偏移
+    size_t highWater;    ///< top 曾达到的最大值
+    Block* last;         ///< 最后分配的块
+    Block* freeLists[FREE_CLASSES];
+    int liveCount;
+    unsigned long failures;
+    WidgetArena* nextArena; ///< 已注册的内存池链表 (供 release 查找)
+
+    static WidgetArena* arenas;
+
+    template <class T>
+    static void destroyObject(void* p) { static_cast<T*>(p)->~T(); }
+
+    bool owns(const void* p) const {
+        return (const uint8_t*)p >= base && (const uint8_t*)p < base + capacity;
+    }
+
+    WidgetArena(const WidgetArena&);
+    WidgetArena& operator=(const WidgetArena&);
+
+public:
+    /**
+     * @param buffer 内存池使用的内存 (按 ALIGN 对齐)，需在内存池的整个生命周期内有效
+     * @param size 字节数
+     */
+    WidgetArena(void* buffer, size_t size);
+    ~WidgetArena();
+
+    /**
+     * @brief 分配对象内存
+     * @param destroy 对象的析构函数 (reset 时调用)
+     * @return 内存不足或对齐要求超过 ALIGN 时返回 nullptr
+     */
+    void* allocate(size_t size, size_t align, void (*destroy)(void*));
+
+    /**
+     * @brief 在内存池中构造对象
+     * @return 内存不足时返回 nullptr (参数不会被使用)
+     */
+    template <class T, class... Args>
+    T* create(Args&&... args) {
+        void* p = allocate(sizeof(T), alignof(T), &destroyObject<T>);
+        return p ? ::new (p) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    /**
+     * @brief 对象已被析构，把它的块还给所属的内存池
+     * @return p 不属于任何内存池时返回 false (应交给全局 operator delete)
+     */
+    static bool release(void* p);
+
+    /**
+     * @brief 按分配顺序析构仍然存活的对象，并回收全部内存
+     */
+    void reset();
+
+    size_t getCapacity() const { return capacity; }
+
+    /**
+     * @brief 当前已分配到的字节数 (含被回收、等待复用的块)
+     */
+    size_t getUsed() const { return top; }
+
+    /**
+     * @brief 使用量的最高水位，用于按产品确定内存池大小
+     */
+    size_t getHighWater() const { return highWater; }
+
+    /**
+     * @brief 存活的对象数
+     */
+    int getLiveCount() const { return liveCount; }
+
+    /**
+     * @brief 因内存池已满而失败的分配次数 (Application::make 会改用堆内存)
+     */
+    unsigned long getFailures() const { return failures; }
+};
+
+/**
+ * @brief 容量在编译期确定的控件内存池 (可定义为全局或静态变量，不占用堆)
+ */
+template <size_t SIZE>
+class StaticWidgetArena : public WidgetArena {
+    union {
+        uint8_t bytes[SIZE];
+        void* pointerAlign;
+        long double floatAlign;
+    } storage;
+
+public:
+    StaticWidgetArena() : WidgetArena(storage.bytes, SIZE) {}
+};
+
+/**
+ * @brief 在内存池中构造控件，内存池为 nullptr 或已满时改用 new
+ */
+template <class T, class... Args>
+T* makeWidget(WidgetArena* arena, Args&&... args) {
+    if (arena) {
+        if (T* w = arena->create<T>(std::forward<Args>(args)...)) return w;
+    }
+    return new T(std::forward<Args>(args)...);
+}
+
+} // namespace Hydrogen
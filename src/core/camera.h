@@ -1,32 +1,62 @@
 #pragma once
-#include <cmath>
+#include "animator.h"
 
 namespace Hydrogen {
 
 /**
  * @brief 虚拟相机类
- * 
+ *
  * 实现了带缓动效果的 2D 坐标跟随系统。
  * 通过改变相机位置，实现整个 UI 层的平移和滚动效果。
+ * 位置以整数像素保存，动画只推进当前位置相对目标的偏移 (Scalar，float 或定点数，参见 fixed.h)，
+ * 定点数模式下长列表的滚动位置不受 Q16.16 整数范围的限制。
+ * 移动动画由 Animator 驱动，未关联 Animator 时 setTarget() 直接跳转。
  */
 class Camera {
 private:
-    float x, y;             ///< 当前位置 (浮点数用于平滑计算)
-    float targetX, targetY; ///< 目标位置
-    float easing;           ///< 缓动系数 (0.0 ~ 1.0)，值越大响应越快
+    int targetX, targetY;    ///< 目标位置
+    Scalar offsetX, offsetY; ///< 当前位置相对目标的偏移 (非整数用于平滑计算，动画中趋向 0)
+    Animator* animator;      ///< 驱动移动动画的调度器 (由 Application 关联)
+    uint16_t duration;       ///< 移动动画时长 (毫秒)
+    Curve curve;             ///< 移动动画曲线
 
 public:
     /**
      * @brief 构造函数
-     * 默认缓动系数为 0.4
+     * 默认 250ms 的 EaseOut 曲线
      */
-    Camera() : x(0), y(0), targetX(0), targetY(0), easing(0.4f) {}
+    Camera() : targetX(0), targetY(0), offsetX(0), offsetY(0), animator(nullptr), duration(250), curve(Curve::EaseOut) {}
+
+    /**
+     * @brief 关联补间调度器
+     */
+    void setAnimator(Animator* a) { animator = a; }
+
+    /**
+     * @brief 设置移动动画的时长与曲线
+     * @param ms 时长 (毫秒)
+     * @param c 缓动曲线
+     */
+    void setDuration(uint16_t ms, Curve c = Curve::EaseOut) {
+        duration = ms;
+        curve = c;
+    }
 
     /**
      * @brief 设置目标位置
-     * 相机会在后续的 update() 中平滑移动到此位置
+     * 相机会在之后的逻辑步长中平滑移动到此位置。目标不变时不会重新开始动画。
      */
-    void setTarget(float tx, float ty) {
+    void setTarget(int tx, int ty) {
+        if (tx == targetX && ty == targetY) return;
+        if (animator) {
+            // 偏移换算到新的目标，当前位置保持不变，再从这里补间到 0
+            offsetX = retargetOffset(offsetX, targetX, tx);
+            offsetY = retargetOffset(offsetY, targetY, ty);
+            animator->animate(&offsetX, Scalar(0), duration, curve);
+            animator->animate(&offsetY, Scalar(0), duration, curve);
+        } else {
+            offsetX = offsetY = Scalar(0);
+        }
         targetX = tx;
         targetY = ty;
     }
@@ -35,38 +65,30 @@ public:
      * @brief 瞬间跳转到指定位置
      * 不产生动画效果
      */
-    void jumpTo(float jx, float jy) {
-        x = targetX = jx;
-        y = targetY = jy;
+    void jumpTo(int jx, int jy) {
+        if (animator) {
+            animator->cancel(&offsetX);
+            animator->cancel(&offsetY);
+        }
+        offsetX = offsetY = Scalar(0);
+        targetX = jx;
+        targetY = jy;
     }
 
     /**
-     * @brief 更新相机状态
-     * 计算下一帧的位置 (线性插值/缓动)
+     * @brief 相机是否仍在向目标位置移动
      */
-    void update() {
-        if (std::abs(targetX - x) > 0.1f) {
-            x += (targetX - x) * easing;
-        } else {
-            x = targetX;
-        }
-
-        if (std::abs(targetY - y) > 0.1f) {
-            y += (targetY - y) * easing;
-        } else {
-            y = targetY;
-        }
-    }
+    bool isMoving() const { return offsetX != Scalar(0) || offsetY != Scalar(0); }
 
     /**
      * @brief 获取当前 X 坐标 (整数)
      */
-    int getX() const { return (int)round(x); }
+    int getX() const { return targetX + scalarRound(offsetX); }
 
     /**
      * @brief 获取当前 Y 坐标 (整数)
      */
-    int getY() const { return (int)round(y); }
+    int getY() const { return targetY + scalarRound(offsetY); }
 };
 
 } // namespace Hydrogen
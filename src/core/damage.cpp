@@ -0,0 +1,80 @@
+#include "damage.h"
+
+namespace Hydrogen {
+
+static int area(const Rect& r) {
+    return r.isEmpty() ? 0 : r.w * r.h;
+}
+
+// 两个矩形相交或边缘相接时视为可合并
+static bool touches(const Rect& a, const Rect& b) {
+    return a.x <= b.x + b.w && b.x <= a.x + a.w &&
+           a.y <= b.y + b.h && b.y <= a.y + a.h;
+}
+
+void DamageTracker::add(const Rect& r) {
+    if (full) return;
+
+    Rect clipped = r.intersect(screen);
+    if (clipped.isEmpty()) return;
+
+    int target = -1;
+
+    // 1. 与已有矩形相交/相邻则合并
+    for (int i = 0; i < count; ++i) {
+        if (touches(rects[i], clipped)) {
+            target = i;
+            break;
+        }
+    }
+
+    if (target < 0 && count < MAX_RECTS) {
+        // 2. 还有空位，作为独立矩形加入
+        rects[count++] = clipped;
+    } else {
+        if (target < 0) {
+            // 3. 列表已满：合并到面积增长最小的矩形
+            int bestGrowth = 0;
+            for (int i = 0; i < count; ++i) {
+                int growth = area(rects[i].unite(clipped)) - area(rects[i]);
+                if (target < 0 || growth < bestGrowth) {
+                    target = i;
+                    bestGrowth = growth;
+                }
+            }
+        }
+        rects[target] = rects[target].unite(clipped);
+        mergeOverlapping(target);
+    }
+
+    // 4. 脏区域已覆盖屏幕的大部分时，整屏刷新反而更省
+    int total = 0;
+    for (int i = 0; i < count; ++i) total += area(rects[i]);
+    if (total * 4 >= area(screen) * 3) invalidateAll();
+}
+
+void DamageTracker::mergeOverlapping(int index) {
+    // 合并后的矩形可能又与其他矩形相接，循环吸收直到稳定
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < count; ++i) {
+            if (i == index || !touches(rects[i], rects[index])) continue;
+            rects[index] = rects[index].unite(rects[i]);
+            // 用最后一个元素填补空位
+            rects[i] = rects[--count];
+            if (index == count) index = i;
+            changed = true;
+            break;
+        }
+    }
+}
+
+Rect DamageTracker::getBounds() const {
+    if (full) return screen;
+    Rect bounds{0, 0, 0, 0};
+    for (int i = 0; i < count; ++i) bounds = bounds.unite(rects[i]);
+    return bounds;
+}
+
+} // namespace Hydrogen
@@ -0,0 +1,86 @@
+#pragma once
+#include "geometry.h"
+
+namespace Hydrogen {
+
+/**
+ * @brief 脏矩形跟踪器
+ *
+ * 收集一帧内屏幕上发生变化的区域（屏幕坐标）。
+ * 采用固定容量的矩形列表，不做任何堆分配：
+ * - 相交或相邻的矩形会被合并
+ * - 列表满时，新矩形合并到使包围面积增长最小的那一个
+ * - 脏区域总面积接近整屏时，直接退化为整屏重绘
+ */
+class DamageTracker {
+public:
+    static const int MAX_RECTS = 4; ///< 最多同时跟踪的独立脏矩形数
+
+private:
+    Rect rects[MAX_RECTS];
+    int count;
+    bool full;    ///< 整屏失效
+    Rect screen;  ///< 屏幕范围
+
+    void mergeOverlapping(int index);
+
+public:
+    DamageTracker() : count(0), full(true), screen{0, 0, 0, 0} {}
+
+    /**
+     * @brief 设置屏幕尺寸，并使整屏失效
+     */
+    void setScreen(int w, int h) {
+        screen = Rect{0, 0, w, h};
+        invalidateAll();
+    }
+
+    /**
+     * @brief 标记一个区域为脏 (屏幕坐标)
+     * 超出屏幕的部分会被裁掉。
+     */
+    void add(const Rect& r);
+
+    /**
+     * @brief 标记整屏为脏
+     */
+    void invalidateAll() {
+        full = true;
+        count = 0;
+    }
+
+    /**
+     * @brief 清空脏区域 (一帧绘制完成后调用)
+     */
+    void reset() {
+        full = false;
+        count = 0;
+    }
+
+    /**
+     * @brief 是否没有任何脏区域
+     */
+    bool isEmpty() const { return !full && count == 0; }
+
+    /**
+     * @brief 是否整屏失效
+     */
+    bool isFull() const { return full; }
+
+    /**
+     * @brief 独立脏矩形数量 (整屏失效时为 0)
+     */
+    int getCount() const { return count; }
+
+    /**
+     * @brief 获取第 i 个脏矩形
+     */
+    const Rect& get(int i) const { return rects[i]; }
+
+    /**
+     * @brief 所有脏矩形的包围盒
+     */
+    Rect getBounds() const;
+};
+
+} // namespace Hydrogen
@@ -0,0 +1,98 @@
+#include "display_list.h"
+#include <string.h>
+
+namespace Hydrogen {
+
+namespace {
+
+const uint32_t FNV_OFFSET = 2166136261u;
+const uint32_t FNV_PRIME = 16777619u;
+
+uint32_t mixWord(uint32_t h, uint32_t v) { return (h ^ v) * FNV_PRIME; }
+
+uint32_t mixBytes(uint32_t h, const char* s, size_t n) {
+    for (size_t i = 0; i < n; ++i) h = mixWord(h, (uint8_t)s[i]);
+    return h;
+}
+
+/**
+ * @brief 逐字段求哈希 (结构体的填充字节不确定，不能整体按字节计算)
+ * FNV-1a 的变体，每次混入 32 位而不是 1 字节，录制时每条命令只需几次乘法。
+ */
+uint32_t mixCommand(uint32_t h, const DrawCommand& c) {
+    h = mixWord(h, (uint32_t)c.op | (uint32_t)c.lowDetail << 8 | (uint32_t)c.textLength << 16);
+    h = mixWord(h, (uint16_t)c.x | (uint32_t)(uint16_t)c.y << 16);
+    h = mixWord(h, (uint16_t)c.w | (uint32_t)(uint16_t)c.h << 16);
+    h = mixWord(h, (uint16_t)c.r);
+    h = mixWord(h, (uint16_t)c.clip.x | (uint32_t)(uint16_t)c.clip.y << 16);
+    h = mixWord(h, (uint16_t)c.clip.w | (uint32_t)(uint16_t)c.clip.h << 16);
+    h = mixWord(h, (uint32_t)(uintptr_t)c.font);
+    return mixWord(h, (uint32_t)(uintptr_t)c.halFont);
+}
+
+} // namespace
+
+DisplayList::DisplayList(DrawCommand* buffer, size_t capacity, char* textBuffer, size_t textCapacity)
+    : commands(buffer), capacity(capacity), count(0), text(textBuffer),
+      textCapacity(textCapacity > 0xFFFF ? 0xFFFF : textCapacity), textUsed(0), area(Rect{0, 0, 0, 0}),
+      hash(FNV_OFFSET), previousHash(0), previousValid(false), stale(true), overflowed(false), highWater(0),
+      missLimit(4), bypassFrames(60), missStreak(0), bypassLeft(0), hits(0), misses(0), bypassed(0) {}
+
+void DisplayList::begin(const Rect& r) {
+    previousValid = !overflowed && !stale;
+    stale = false;
+    previousHash = hash;
+    count = 0;
+    textUsed = 0;
+    overflowed = false;
+    area = r;
+    hash = mixWord(mixWord(FNV_OFFSET, (uint16_t)r.x | (uint32_t)(uint16_t)r.y << 16),
+                   (uint16_t)r.w | (uint32_t)(uint16_t)r.h << 16);
+}
+
+void DisplayList::end() {
+    if (!overflowed && !previousValid) return;
+    if (matchesPrevious()) {
+        ++hits;
+        missStreak = 0;
+        return;
+    }
+    ++misses;
+    if (missLimit > 0 && ++missStreak >= missLimit) {
+        // 旁路结束后的试探帧只要再未命中一次就重新旁路
+        bypassLeft = bypassFrames;
+        missStreak = missLimit - 1;
+    }
+}
+
+bool DisplayList::shouldRecord() {
+    if (bypassLeft == 0) return true;
+    --bypassLeft;
+    ++bypassed;
+    invalidate(); // 直接绘制的画面不在列表中
+    return false;
+}
+
+bool DisplayList::append(const DrawCommand& c, const char* s, size_t length) {
+    if (overflowed) return false;
+    if (count >= capacity || length > textCapacity - textUsed) {
+        overflowed = true;
+        return false;
+    }
+
+    DrawCommand& slot = commands[count++];
+    slot = c;
+    if (count > highWater) highWater = count;
+    if (s) {
+        memcpy(text + textUsed, s, length);
+        slot.textOffset = (uint16_t)textUsed;
+        slot.textLength = (uint16_t)length;
+        textUsed += length;
+        hash = mixBytes(hash, s, length);
+    }
+    // 包围盒由其他字段决定，无需计入
+    hash = mixCommand(hash, slot);
+    return true;
+}
+
+} // namespace Hydrogen
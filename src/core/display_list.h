@@ -0,0 +1,202 @@
+#pragma once
+#include "font.h"
+#include "geometry.h"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Hydrogen {
+
+/**
+ * @brief 显示列表中的一条绘图命令 (定长，坐标已换算为屏幕坐标)
+ */
+struct DrawCommand {
+    enum class Op : uint8_t { Line, Rect, FillRect, Circle, FillCircle, RoundRect, Text };
+
+    /**
+     * @brief 16 位的矩形 (屏幕坐标)
+     */
+    struct Box {
+        int16_t x, y, w, h;
+        Rect toRect() const { return Rect{x, y, w, h}; }
+    };
+
+    Op op;
+    uint8_t lowDetail;       ///< 记录时是否为简化绘制
+    int16_t x, y, w, h;      ///< Line: 两个端点 (x, y) - (w, h)；Circle: 圆心与半径 (w)；Text: 基线位置
+    int16_t r;               ///< RoundRect: 圆角半径
+    uint16_t textLength;     ///< Text: 文本字节数
+    uint16_t textOffset;     ///< Text: 文本在列表文本区中的偏移
+    Box clip;                ///< 记录时的裁剪区域
+    Box bounds;              ///< 包围盒 (已与裁剪区域求交)
+    const Font* font;        ///< Text: 原生字体，nullptr 表示 HAL 自带字体
+    const void* halFont;     ///< Text: 使用 HAL 字体时记录 HAL::getFontId()，只参与哈希 (字体切换后画面不同)
+};
+
+/**
+ * @brief 显示列表：录制一帧的绘图命令，之后可按任意裁剪区域回放到任意 HAL
+ *
+ * Graphics::beginRecording() 之后，drawLine/drawRect/fillRect/drawCircle/fillCircle/
+ * drawRoundRect/drawText 不再立即光栅化，而是把定长命令追加到预先分配的缓冲区；
+ * 完全在裁剪区外的图元不会被记录。文本被复制进列表自带的文本区 (调用方的缓冲区可能是临时的)。
+ * 回放 (Graphics::replay) 跳过包围盒与回放区域不相交的命令，可用于分块或按 U8g2 页回放。
+ *
+ * 录制的同时对命令流求哈希 (按 32 位混入的 FNV-1a，包括录制区域与文本的字体)。与上一帧的哈希相同 (matchesPrevious)
+ * 说明本帧画出的像素与上一帧完全一致，Application 据此跳过清屏、光栅化和刷新。
+ *
+ * 命令或文本超出容量、或坐标超出 16 位时列表标记为溢出：Application 清除脏区域并回放已录制的命令，
+ * 控件树余下的部分直接绘制 (控件树只遍历一次)。
+ *
+ * 画面每帧都在变化时录制与回放只是额外开销。连续 missLimit 帧哈希未命中 (溢出也算未命中) 后，
+ * 接下来 bypassFrames 帧不再录制、直接绘制，之后重新录制两帧试探：第一帧建立基准，
+ * 第二帧仍未命中则立即再次旁路。getHits()/getMisses() 可用于估计命中率。
+ *
+ * @code
+ *   static StaticDisplayList<256> displayList;
+ *   App.setDisplayList(&displayList);
+ * @endcode
+ */
+class DisplayList {
+    DrawCommand* commands;
+    size_t capacity;
+    size_t count;
+    char* text;
+    size_t textCapacity;
+    size_t textUsed;
+    Rect area;              ///< 录制区域 (屏幕坐标)
+    uint32_t hash;
+    uint32_t previousHash;
+    bool previousValid;     ///< previousHash 对应一帧完整录制并已光栅化的画面
+    bool stale;             ///< 当前一帧不能作为下一帧比较的基准
+    bool overflowed;
+    size_t highWater;       ///< 单帧命令数的最大值
+    int missLimit;          ///< 连续未命中多少帧后旁路，0 表示始终录制
+    int bypassFrames;       ///< 每次旁路的帧数
+    int missStreak;         ///< 连续未命中的帧数
+    int bypassLeft;         ///< 本次旁路剩余的帧数
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long bypassed;
+
+    DisplayList(const DisplayList&);
+    DisplayList& operator=(const DisplayList&);
+
+public:
+    /**
+     * @param buffer 命令缓冲区，需在列表的整个生命周期内有效
+     * @param capacity 命令数
+     * @param textBuffer 文本区 (不超过 65535 字节)
+     * @param textCapacity 文本区字节数
+     */
+    DisplayList(DrawCommand* buffer, size_t capacity, char* textBuffer, size_t textCapacity);
+
+    /**
+     * @brief 开始录制新的一帧 (由 Graphics::beginRecording 调用)
+     * 上一帧未溢出时保留它的哈希，供 matchesPrevious() 比较。
+     * @param area 录制区域 (屏幕坐标)
+     */
+    void begin(const Rect& area);
+
+    /**
+     * @brief 结束一帧的录制，统计是否命中 (由 Graphics 在录制结束或溢出转为直接绘制时调用)
+     * 没有可比较的上一帧 (首帧、invalidate() 之后) 时不计入命中或未命中。
+     */
+    void end();
+
+    /**
+     * @brief 这一帧是否录制 (每帧绘制前调用一次)
+     * 处于旁路期时消耗一帧旁路并返回 false：调用方直接绘制，列表随之忘记上一帧。
+     */
+    bool shouldRecord();
+
+    /**
+     * @brief 设置自适应旁路 (默认连续 4 帧未命中后旁路 60 帧)
+     * @param missLimit 连续未命中的帧数，0 表示始终录制
+     * @param bypassFrames 每次旁路的帧数
+     */
+    void setAdaptive(int missLimit, int bypassFrames) {
+        this->missLimit = missLimit;
+        this->bypassFrames = bypassFrames;
+        missStreak = 0;
+        bypassLeft = 0;
+    }
+
+    /**
+     * @brief 追加一条命令
+     * @param s 文本 (Text 命令)，复制进文本区
+     * @return 缓冲区已满时返回 false，列表标记为溢出
+     */
+    bool append(const DrawCommand& c, const char* s = nullptr, size_t length = 0);
+
+    /**
+     * @brief 标记本帧无法完整录制 (如坐标超出 16 位)
+     */
+    void markOverflow() { overflowed = true; }
+
+    /**
+     * @brief 本帧与上一帧的命令流 (及录制区域) 哈希相同，且两帧都完整录制
+     */
+    bool matchesPrevious() const { return previousValid && !overflowed && hash == previousHash; }
+
+    /**
+     * @brief 忘记上一帧 (屏幕内容被列表之外的绘制改变时调用)，下一帧一定会光栅化
+     */
+    void invalidate() {
+        previousValid = false;
+        stale = true;
+    }
+
+    size_t getCount() const { return count; }
+    size_t getCapacity() const { return capacity; }
+    const DrawCommand& get(size_t i) const { return commands[i]; }
+    const char* textOf(const DrawCommand& c) const { return text + c.textOffset; }
+    Rect getArea() const { return area; }
+    uint32_t getHash() const { return hash; }
+    bool isOverflowed() const { return overflowed; }
+
+    /**
+     * @brief 单帧命令数的最高水位，用于按产品确定容量
+     */
+    size_t getHighWater() const { return highWater; }
+
+    /**
+     * @brief 与上一帧比较后命中 (跳过光栅化) 的帧数
+     */
+    unsigned long getHits() const { return hits; }
+
+    /**
+     * @brief 与上一帧比较后未命中或溢出的帧数
+     */
+    unsigned long getMisses() const { return misses; }
+
+    /**
+     * @brief 处于旁路期而未录制的帧数
+     */
+    unsigned long getBypassedFrames() const { return bypassed; }
+
+    /**
+     * @brief 清零命中统计
+     */
+    void resetStats() {
+        hits = 0;
+        misses = 0;
+        bypassed = 0;
+    }
+};
+
+/**
+ * @brief 容量在编译期确定的显示列表 (可定义为全局或静态变量，不占用堆)
+ * @tparam COMMANDS 命令数
+ * @tparam TEXT_BYTES 文本区字节数
+ */
+template <size_t COMMANDS, size_t TEXT_BYTES = COMMANDS * 8>
+class StaticDisplayList : public DisplayList {
+    static_assert(TEXT_BYTES <= 0xFFFF, "display list text area is limited to 65535 bytes");
+
+    DrawCommand commandStorage[COMMANDS];
+    char textStorage[TEXT_BYTES];
+
+public:
+    StaticDisplayList() : DisplayList(commandStorage, COMMANDS, textStorage, TEXT_BYTES) {}
+};
+
+} // namespace Hydrogen
@@ -0,0 +1,121 @@
+#pragma once
+#include <stdint.h>
+
+namespace Hydrogen {
+
+/**
+ * @brief Q16.16 定点数
+ *
+ * 用 32 位整数表示实数：高 16 位为整数部分，低 16 位为小数部分。
+ * 在没有 FPU 的 MCU (Cortex-M0、ESP8266 等) 上，加减为单条整数指令，
+ * 乘法为一次 32x32->64 位乘法加移位，远快于软件浮点库。
+ *
+ * 由常量 (如 Fixed(0.3f)) 构造时编译器会在编译期完成换算；
+ * 由运行时的 float 构造仍需软件浮点，只应出现在 API 边界 (如 setValue)。
+ */
+class Fixed {
+private:
+    int32_t raw;
+
+    struct RawTag {};
+    constexpr Fixed(int32_t r, RawTag) : raw(r) {}
+
+public:
+    static const int FRAC_BITS = 16;
+    static const int32_t ONE = (int32_t)1 << FRAC_BITS;
+
+    constexpr Fixed() : raw(0) {}
+    /// 整数部分只有 16 位：|v| 超过 32767 时溢出。像素坐标应以 int 保存，只把补间中的偏移放进 Fixed
+    constexpr Fixed(int v) : raw((int32_t)v * ONE) {}
+    constexpr Fixed(float v) : raw((int32_t)(v * ONE + (v >= 0 ? 0.5f : -0.5f))) {}
+    constexpr Fixed(double v) : raw((int32_t)(v * ONE + (v >= 0 ? 0.5 : -0.5))) {}
+
+    /**
+     * @brief 由原始 Q16.16 值构造
+     */
+    static constexpr Fixed fromRaw(int32_t r) { return Fixed(r, RawTag()); }
+
+    /**
+     * @brief 获取原始 Q16.16 值
+     */
+    constexpr int32_t getRaw() const { return raw; }
+
+    /**
+     * @brief 向零截断为整数
+     */
+    int toInt() const { return raw >= 0 ? (int)(raw >> FRAC_BITS) : -(int)((-raw) >> FRAC_BITS); }
+
+    /**
+     * @brief 四舍五入为整数
+     */
+    int round() const { return raw >= 0 ? (int)((raw + ONE / 2) >> FRAC_BITS) : -(int)((-raw + ONE / 2) >> FRAC_BITS); }
+
+    /**
+     * @brief 转换为浮点数 (需要浮点运算，仅用于 API 边界或调试)
+     */
+    float toFloat() const { return (float)raw / ONE; }
+
+    Fixed operator-() const { return fromRaw(-raw); }
+    Fixed& operator+=(Fixed o) { raw += o.raw; return *this; }
+    Fixed& operator-=(Fixed o) { raw -= o.raw; return *this; }
+    Fixed& operator*=(Fixed o) { *this = *this * o; return *this; }
+
+    friend Fixed operator+(Fixed a, Fixed b) { return fromRaw(a.raw + b.raw); }
+    friend Fixed operator-(Fixed a, Fixed b) { return fromRaw(a.raw - b.raw); }
+    // 乘法结果四舍五入，避免截断误差在缓动中逐帧累积
+    friend Fixed operator*(Fixed a, Fixed b) { return fromRaw((int32_t)(((int64_t)a.raw * b.raw + ONE / 2) >> FRAC_BITS)); }
+    friend Fixed operator/(Fixed a, Fixed b) { return fromRaw((int32_t)(((int64_t)a.raw * ONE) / b.raw)); }
+
+    friend bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+    friend bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+    friend bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+    friend bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+    friend bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+    friend bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+};
+
+/**
+ * @brief 动画使用的数值类型
+ *
+ * 默认使用 float。在没有 FPU 的平台上，编译时定义 HYDROGEN_FIXED_POINT
+ * (如 PlatformIO: build_flags = -DHYDROGEN_FIXED_POINT) 即可切换为 Q16.16 定点数。
+ */
+#ifdef HYDROGEN_FIXED_POINT
+typedef Fixed Scalar;
+#else
+typedef float Scalar;
+#endif
+
+// ---- 与具体数值类型无关的辅助函数 ----
+
+inline int scalarRound(float v) { return (int)(v >= 0 ? v + 0.5f : v - 0.5f); }
+inline int scalarRound(Fixed v) { return v.round(); }
+
+inline int scalarToInt(float v) { return (int)v; }
+inline int scalarToInt(Fixed v) { return v.toInt(); }
+
+inline float scalarToFloat(float v) { return v; }
+inline float scalarToFloat(Fixed v) { return v.toFloat(); }
+
+/**
+ * @brief 补间偏移的上限 (像素)
+ * 大坐标以 int 保存，补间只推进当前位置相对目标的偏移；偏移限制在此范围内，
+ * 定点数模式下不会溢出。跳转距离更远时动画从这个距离处开始。
+ */
+const int MAX_TWEEN_OFFSET = 8192;
+
+/**
+ * @brief 目标由 from 改为 to 时，把位置差累加到偏移上 (限制在 ±MAX_TWEEN_OFFSET 内)
+ * 位置 = 目标 + 偏移，累加后当前位置不变 (超出上限时除外)。
+ */
+inline Scalar retargetOffset(Scalar offset, int from, int to) {
+    int delta = from - to;
+    if (delta > MAX_TWEEN_OFFSET) delta = MAX_TWEEN_OFFSET;
+    if (delta < -MAX_TWEEN_OFFSET) delta = -MAX_TWEEN_OFFSET;
+    Scalar v = offset + Scalar(delta);
+    if (v > Scalar(MAX_TWEEN_OFFSET)) return Scalar(MAX_TWEEN_OFFSET);
+    if (v < Scalar(-MAX_TWEEN_OFFSET)) return Scalar(-MAX_TWEEN_OFFSET);
+    return v;
+}
+
+} // namespace Hydrogen
@@ -0,0 +1,78 @@
+#include "font.h"
+
+namespace Hydrogen {
+
+uint32_t decodeUtf8(const char*& p, const char* end) {
+    const uint8_t* s = (const uint8_t*)p;
+    uint8_t c = s[0];
+    if (c < 0x80) {
+        p += 1;
+        return c;
+    }
+
+    // 首字节决定序列长度与最小码位 (拒绝过长编码)
+    int len;
+    uint32_t cp, min;
+    if ((c & 0xE0) == 0xC0) { len = 2; cp = c & 0x1F; min = 0x80; }
+    else if ((c & 0xF0) == 0xE0) { len = 3; cp = c & 0x0F; min = 0x800; }
+    else if ((c & 0xF8) == 0xF0) { len = 4; cp = c & 0x07; min = 0x10000; }
+    else { p += 1; return 0xFFFD; }
+    if (end && end - p < len) { p += 1; return 0xFFFD; } // 序列被截断
+
+    for (int i = 1; i < len; ++i) {
+        // 遇到 '\0' 也会在这里停下，不会越过字符串末尾
+        if ((s[i] & 0xC0) != 0x80) { p += 1; return 0xFFFD; }
+        cp = (cp << 6) | (s[i] & 0x3F);
+    }
+    if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) { p += 1; return 0xFFFD; }
+    p += len;
+    return cp;
+}
+
+const FontGlyph* Font::find(uint32_t codepoint) const {
+    if (glyphCount == 0 || codepoint > 0xFFFF) return nullptr;
+
+    // 多数字库的 ASCII 部分是连续的，先尝试直接索引
+    uint32_t first = codepoints[0];
+    if (codepoint >= first && codepoint - first < glyphCount && codepoints[codepoint - first] == codepoint) {
+        return &glyphs[codepoint - first];
+    }
+
+    int lo = 0;
+    int hi = glyphCount - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) >> 1;
+        uint16_t c = codepoints[mid];
+        if (c == codepoint) return &glyphs[mid];
+        if (c < codepoint) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return nullptr;
+}
+
+const FontGlyph* Font::glyphFor(uint32_t codepoint) const {
+    const FontGlyph* g = find(codepoint);
+    if (!g && fallback) g = find(fallback);
+    return g;
+}
+
+int Font::measure(const char* s) const {
+    int w = 0;
+    while (*s) {
+        const FontGlyph* g = glyphFor(decodeUtf8(s));
+        if (g) w += g->advance;
+    }
+    return w;
+}
+
+int Font::measure(const char* s, size_t length) const {
+    int w = 0;
+    const char* end = s + length;
+    while (s < end) {
+        const FontGlyph* g = glyphFor(decodeUtf8(s, end));
+        if (g) w += g->advance;
+    }
+    return w;
+}
+
+} // namespace Hydrogen
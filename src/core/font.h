@@ -0,0 +1,70 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+namespace Hydrogen {
+
+/**
+ * @brief 单个字形的度量与位图位置
+ */
+struct FontGlyph {
+    uint32_t offset;  ///< 位图在 Font::bitmaps 中的字节偏移
+    uint8_t width;    ///< 位图宽度 (像素)
+    uint8_t height;   ///< 位图高度 (像素)
+    uint8_t advance;  ///< 绘制后笔位前进的像素数
+    int8_t x;         ///< 位图左边相对笔位的偏移
+    int8_t y;         ///< 位图顶边相对基线的偏移 (向上为负)
+};
+
+/**
+ * @brief 原生位图字体
+ *
+ * 紧凑的只读格式，可整体放在 Flash 中 (由 tools/bdf2hydrogen.py 从 BDF 生成)：
+ * - codepoints：按升序排列的码位表，查找字形用二分搜索 (适合数千字的中文字库)
+ * - glyphs：与码位表一一对应的字形度量
+ * - bitmaps：1bpp 位图，XBM 布局 (每行 (width + 7) / 8 字节，字节内低位在左)，
+ *   可直接交给 HAL::drawXBM 绘制，无需解码
+ *
+ * 仅支持基本多文种平面 (U+0000 ~ U+FFFF)。
+ */
+struct Font {
+    const uint16_t* codepoints; ///< 升序码位表
+    const FontGlyph* glyphs;    ///< 字形表，与 codepoints 等长
+    const uint8_t* bitmaps;     ///< 位图数据
+    uint16_t glyphCount;        ///< 字形数
+    uint8_t ascent;             ///< 基线以上的最大高度
+    uint8_t descent;            ///< 基线以下的最大深度
+    uint16_t fallback;          ///< 缺字时使用的码位 (如 '?')，0 表示跳过缺字
+
+    /**
+     * @brief 查找码位对应的字形
+     * @return 字形指针，字库中没有时返回 nullptr
+     */
+    const FontGlyph* find(uint32_t codepoint) const;
+
+    /**
+     * @brief 查找码位对应的字形，缺字时退回 fallback
+     */
+    const FontGlyph* glyphFor(uint32_t codepoint) const;
+
+    /**
+     * @brief 测量 UTF-8 文本的宽度 (各字形前进量之和)
+     */
+    int measure(const char* s) const;
+
+    /**
+     * @brief 测量 UTF-8 文本前 length 字节的宽度 (文本无需以 '\0' 结尾)
+     */
+    int measure(const char* s, size_t length) const;
+};
+
+/**
+ * @brief 解码一个 UTF-8 字符并前移指针
+ * 非法或截断的序列返回 U+FFFD，并只前移一个字节。
+ * @param p 指向当前字符的首字节，返回时指向下一个字符
+ * @param end 文本末尾 (不含)，nullptr 表示文本以 '\0' 结尾
+ * @return 码位
+ */
+uint32_t decodeUtf8(const char*& p, const char* end = nullptr);
+
+} // namespace Hydrogen
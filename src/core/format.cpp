@@ -0,0 +1,93 @@
+#include "format.h"
+#include <string.h>
+#include <stdint.h>
+
+namespace Hydrogen {
+
+TextBuilder::TextBuilder(char* buffer, size_t size) : buf(buffer), capacity(size), len(0), full(false) {
+    buf[0] = '\0';
+}
+
+void TextBuilder::clear() {
+    len = 0;
+    full = false;
+    buf[0] = '\0';
+}
+
+void TextBuilder::put(const char* s, size_t n) {
+    size_t room = capacity - 1 - len;
+    if (n > room) {
+        n = room;
+        full = true;
+        while (n > 0 && ((uint8_t)s[n] & 0xC0) == 0x80) --n; // 不截断多字节字符
+    }
+    memcpy(buf + len, s, n);
+    len += n;
+    buf[len] = '\0';
+}
+
+TextBuilder& TextBuilder::append(const char* s) {
+    if (s) put(s, strlen(s));
+    return *this;
+}
+
+TextBuilder& TextBuilder::append(char c) {
+    put(&c, 1);
+    return *this;
+}
+
+TextBuilder& TextBuilder::append(unsigned long value) {
+    char digits[20];
+    int n = 0;
+    do {
+        digits[sizeof(digits) - 1 - n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    put(digits + sizeof(digits) - n, n);
+    return *this;
+}
+
+TextBuilder& TextBuilder::append(long value) {
+    return appendPadded(value, 1);
+}
+
+TextBuilder& TextBuilder::appendPadded(long value, int minDigits) {
+    // 取绝对值时避免 LONG_MIN 溢出
+    unsigned long magnitude = value < 0 ? 0UL - (unsigned long)value : (unsigned long)value;
+    if (value < 0) append('-');
+
+    char digits[20];
+    int n = 0;
+    do {
+        digits[sizeof(digits) - 1 - n++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude || (n < minDigits && n < (int)sizeof(digits)));
+    put(digits + sizeof(digits) - n, n);
+    return *this;
+}
+
+TextBuilder& TextBuilder::appendFixed(float value, int decimals) {
+    if (decimals < 0) decimals = 0;
+    if (decimals > 6) decimals = 6;
+
+    unsigned long scale = 1;
+    for (int i = 0; i < decimals; ++i) scale *= 10;
+
+    bool negative = value < 0.0f;
+    float magnitude = (negative ? -value : value) * (float)scale + 0.5f;
+    if (magnitude >= 4294967295.0f) magnitude = 4294967295.0f; // 超出范围时饱和
+    unsigned long scaled = (unsigned long)magnitude;
+
+    if (negative && scaled) append('-');
+    append(scaled / scale);
+    if (decimals) {
+        append('.');
+        // 小数部分补足前导 0
+        unsigned long frac = scaled % scale;
+        for (unsigned long d = scale / 10; d > 1 && frac < d; d /= 10) append('0');
+        append(frac);
+    }
+    return *this;
+}
+
+} // namespace Hydrogen
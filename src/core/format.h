@@ -0,0 +1,65 @@
+#pragma once
+#include <stddef.h>
+
+namespace Hydrogen {
+
+/**
+ * @brief 在调用者提供的缓冲区中拼接文本
+ *
+ * 用于每帧都可能变化的数值文本 (FPS、百分比、计数)，代替 std::string 拼接和 snprintf：
+ * 不分配堆内存，也不会引入 printf 家族庞大的代码体积。
+ * 缓冲区写满后多余的内容被丢弃 (不会截断半个 UTF-8 字符)，结果始终以 '\0' 结尾。
+ *
+ * @code
+ *   char buf[16];
+ *   TextBuilder(buf, sizeof(buf)).append("FPS: ").append(fps);
+ * @endcode
+ */
+class TextBuilder {
+    char* buf;
+    size_t capacity; ///< 缓冲区大小 (含 '\0')
+    size_t len;
+    bool full;       ///< 是否有内容因缓冲区已满被丢弃
+
+    void put(const char* s, size_t n);
+
+public:
+    /**
+     * @param buffer 输出缓冲区
+     * @param size 缓冲区字节数 (至少为 1)
+     */
+    TextBuilder(char* buffer, size_t size);
+
+    TextBuilder& append(const char* s);
+    TextBuilder& append(char c);
+    TextBuilder& append(long value);
+    TextBuilder& append(unsigned long value);
+    TextBuilder& append(int value) { return append((long)value); }
+    TextBuilder& append(unsigned int value) { return append((unsigned long)value); }
+
+    /**
+     * @brief 追加整数，不足 minDigits 位时在前面补 0 (如时钟的 "09")
+     */
+    TextBuilder& appendPadded(long value, int minDigits);
+
+    /**
+     * @brief 追加定点格式的小数 (四舍五入)
+     * @param decimals 小数位数 (0 ~ 6)
+     */
+    TextBuilder& appendFixed(float value, int decimals);
+
+    /**
+     * @brief 清空内容，从头开始拼接
+     */
+    void clear();
+
+    const char* c_str() const { return buf; }
+    size_t length() const { return len; }
+
+    /**
+     * @brief 是否有内容因缓冲区不足被丢弃
+     */
+    bool overflowed() const { return full; }
+};
+
+} // namespace Hydrogen
@@ -0,0 +1,58 @@
+#pragma once
+
+namespace Hydrogen {
+
+/**
+ * @brief 2D 坐标点结构
+ */
+struct Point {
+    int x, y;
+};
+
+/**
+ * @brief 矩形区域结构
+ */
+struct Rect {
+    int x, y, w, h;
+
+    /**
+     * @brief 是否为空矩形 (宽或高不大于 0)
+     */
+    bool isEmpty() const { return w <= 0 || h <= 0; }
+
+    /**
+     * @brief 判断两个矩形是否相交
+     */
+    bool intersects(const Rect& o) const {
+        return !isEmpty() && !o.isEmpty() &&
+               x < o.x + o.w && o.x < x + w &&
+               y < o.y + o.h && o.y < y + h;
+    }
+
+    /**
+     * @brief 求交集 (不相交时返回空矩形)
+     */
+    Rect intersect(const Rect& o) const {
+        int x0 = x > o.x ? x : o.x;
+        int y0 = y > o.y ? y : o.y;
+        int x1 = (x + w < o.x + o.w) ? x + w : o.x + o.w;
+        int y1 = (y + h < o.y + o.h) ? y + h : o.y + o.h;
+        if (x1 <= x0 || y1 <= y0) return Rect{0, 0, 0, 0};
+        return Rect{x0, y0, x1 - x0, y1 - y0};
+    }
+
+    /**
+     * @brief 求包围两个矩形的最小矩形 (空矩形不参与合并)
+     */
+    Rect unite(const Rect& o) const {
+        if (isEmpty()) return o;
+        if (o.isEmpty()) return *this;
+        int x0 = x < o.x ? x : o.x;
+        int y0 = y < o.y ? y : o.y;
+        int x1 = (x + w > o.x + o.w) ? x + w : o.x + o.w;
+        int y1 = (y + h > o.y + o.h) ? y + h : o.y + o.h;
+        return Rect{x0, y0, x1 - x0, y1 - y0};
+    }
+};
+
+} // namespace Hydrogen
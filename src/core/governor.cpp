@@ -0,0 +1,67 @@
+#include "governor.h"
+
+namespace Hydrogen {
+
+FrameGovernor::FrameGovernor() : budgetUs(16000), maxLevel(MAX_LEVEL) {
+    reset();
+}
+
+void FrameGovernor::reset() {
+    level = 0;
+    overStreak = 0;
+    underStreak = 0;
+    restoreAfter = RESTORE_AFTER;
+    sinceRestore = MAX_RESTORE_AFTER;
+    overruns = 0;
+    frameUs = 0;
+    for (int i = 0; i < (int)Phase::Count; ++i) phaseUs[i] = 0;
+}
+
+void FrameGovernor::setMaxLevel(int max) {
+    if (max < 0) max = 0;
+    if (max > MAX_LEVEL) max = MAX_LEVEL;
+    maxLevel = max;
+    if (level > maxLevel) level = maxLevel;
+}
+
+bool FrameGovernor::report(unsigned long updateUs, unsigned long drawUs, unsigned long flushUs) {
+    phaseUs[(int)Phase::Update] = updateUs;
+    phaseUs[(int)Phase::Draw] = drawUs;
+    phaseUs[(int)Phase::Flush] = flushUs;
+    frameUs = updateUs + drawUs + flushUs;
+
+    if (sinceRestore < MAX_RESTORE_AFTER) sinceRestore++;
+
+    if (frameUs > budgetUs) {
+        overruns++;
+        underStreak = 0;
+        if (++overStreak >= DEGRADE_AFTER && level < maxLevel) {
+            // 刚恢复就再次超时说明余量不够，下次恢复前多观察一段时间；
+            // 恢复后稳定运行了足够久则撤销退避
+            if (sinceRestore < restoreAfter) {
+                if (restoreAfter < MAX_RESTORE_AFTER) restoreAfter *= 2;
+            } else {
+                restoreAfter = RESTORE_AFTER;
+            }
+            level++;
+            overStreak = 0;
+            return true;
+        }
+    } else {
+        overStreak = 0;
+        // 刚好卡在预算内不算余量，否则恢复后会立即再次超时
+        if (frameUs * 100 <= budgetUs * HEADROOM_PERCENT) {
+            if (++underStreak >= restoreAfter && level > 0) {
+                level--;
+                underStreak = 0;
+                sinceRestore = 0;
+                return true;
+            }
+        } else {
+            underStreak = 0;
+        }
+    }
+    return false;
+}
+
+} // namespace Hydrogen
@@ -0,0 +1,97 @@
+#pragma once
+#include <stdint.h>
+
+namespace Hydrogen {
+
+/**
+ * @brief 帧预算调节器
+ *
+ * Application 每绘制一帧就上报各阶段耗时 (微秒)。连续超出预算时逐级降低画质，
+ * 连续留有余量时逐级恢复：
+ * - 0 级：完整画质
+ * - 1 级：跳过装饰性控件 (Widget::isDecorative()，如 MatrixRain)
+ * - 2 级：简化圆角/圆形的绘制，相机滚动合并为较大的步进以减少整屏重绘
+ * - 3 级：隔帧刷新 (脏区域累积到下一帧一起处理)
+ *
+ * 降级与恢复都带迟滞，避免在临界负载下反复切换：恢复后很快又需要降级时，
+ * 下一次恢复所需的余量帧数加倍 (最多 16 倍)。
+ */
+class FrameGovernor {
+public:
+    /**
+     * @brief 帧内的阶段
+     */
+    enum class Phase : uint8_t {
+        Update,  ///< 逻辑步长 (补间与控件 update)
+        Draw,    ///< 清除与绘制
+        Flush,   ///< 推送到屏幕
+        Count
+    };
+
+    static const int MAX_LEVEL = 3;       ///< 最低画质等级
+    static const int DEGRADE_AFTER = 3;   ///< 连续超预算多少帧后降一级
+    static const int RESTORE_AFTER = 60;  ///< 连续留有余量多少帧后升一级
+    static const int MAX_RESTORE_AFTER = RESTORE_AFTER * 16; ///< 退避后的上限
+    static const int HEADROOM_PERCENT = 60; ///< 帧耗时低于预算的此比例才算留有余量
+
+private:
+    unsigned long budgetUs;
+    int level;
+    int maxLevel;
+    int overStreak;   ///< 连续超预算的帧数
+    int underStreak;  ///< 连续留有余量的帧数
+    int restoreAfter; ///< 当前恢复一级所需的余量帧数 (随反复降级加倍)
+    int sinceRestore; ///< 距上次恢复的帧数
+    unsigned long overruns;
+    unsigned long frameUs;
+    unsigned long phaseUs[(int)Phase::Count];
+
+public:
+    FrameGovernor();
+
+    /**
+     * @brief 设置帧预算
+     * @param us 每帧允许的耗时 (微秒)，默认 16000
+     */
+    void setBudget(unsigned long us) { budgetUs = us; }
+    unsigned long getBudget() const { return budgetUs; }
+
+    /**
+     * @brief 限制允许降到的最低画质等级
+     * @param max 0 表示禁用自动降级，MAX_LEVEL 表示不限制
+     */
+    void setMaxLevel(int max);
+
+    /**
+     * @brief 上报一帧的各阶段耗时
+     * @return 画质等级是否因此发生变化
+     */
+    bool report(unsigned long updateUs, unsigned long drawUs, unsigned long flushUs);
+
+    /**
+     * @brief 当前画质等级 (0 = 完整画质)
+     */
+    int getLevel() const { return level; }
+
+    /**
+     * @brief 超出预算的累计帧数
+     */
+    unsigned long getOverruns() const { return overruns; }
+
+    /**
+     * @brief 最近一帧的总耗时 (微秒)
+     */
+    unsigned long getFrameUs() const { return frameUs; }
+
+    /**
+     * @brief 最近一帧某个阶段的耗时 (微秒)
+     */
+    unsigned long getPhaseUs(Phase p) const { return phaseUs[(int)p]; }
+
+    /**
+     * @brief 恢复完整画质并清空统计
+     */
+    void reset();
+};
+
+} // namespace Hydrogen
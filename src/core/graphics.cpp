@@ -1,53 +1,340 @@
 #include "graphics.h"
 #include <cmath>
+#include <utility>
+#include <algorithm>
+#include <string.h>
 
 namespace Hydrogen {
 
+namespace {
+
+bool fitsInt16(int v) { return v >= -32768 && v <= 32767; }
+
+DrawCommand::Box toBox(const Rect& r) {
+    return DrawCommand::Box{(int16_t)r.x, (int16_t)r.y, (int16_t)r.w, (int16_t)r.h};
+}
+
+} // namespace
+
+bool Graphics::record(DrawCommand::Op op, int x, int y, int w, int h, int r, const Rect& bounds, const char* text,
+                      size_t length) {
+    Rect visible = bounds.intersect(clip);
+    if (visible.isEmpty()) return true;
+    if (!fitsInt16(x) || !fitsInt16(y) || !fitsInt16(w) || !fitsInt16(h) || !fitsInt16(r) || length > 0xFFFF) {
+        recorder->markOverflow();
+        return !overflowToDirect();
+    }
+
+    DrawCommand c;
+    c.op = op;
+    c.lowDetail = lowDetail ? 1 : 0;
+    c.x = (int16_t)x;
+    c.y = (int16_t)y;
+    c.w = (int16_t)w;
+    c.h = (int16_t)h;
+    c.r = (int16_t)r;
+    c.textLength = 0;
+    c.textOffset = 0;
+    c.clip = toBox(clip);
+    c.bounds = toBox(visible);
+    c.font = text ? font : nullptr;
+    // 与 TextWidthCache 一致：没有原生字体时以 HAL 的字体标识区分 U8g2 字体
+    c.halFont = text && !font ? hal->getFontId() : nullptr;
+    return recorder->append(c, text, length) || !overflowToDirect();
+}
+
+bool Graphics::overflowToDirect() {
+    if (!overflowHandler) return false;
+    DisplayList* list = recorder;
+    list->end();
+    recorder = nullptr;
+    // 清除脏区域后补画已录制的部分，当前图元与控件树的其余部分接着直接绘制
+    // 此时 HAL 的裁剪窗口是嵌套控件的裁剪区，清除前先放开 (replay 结束时恢复)
+    hal->setClipWindow(0, 0, hal->getWidth(), hal->getHeight());
+    overflowHandler(overflowUser);
+    replay(*list, list->getArea());
+    return true;
+}
+
+bool Graphics::recordText(int sx, int sy, const char* text, size_t length) {
+    // 与 drawNativeText 的剔除范围一致
+    int top = font ? sy - font->ascent : sy - 32;
+    int bottom = font ? sy + font->descent : sy + 8;
+    int right = clip.x + clip.w;
+    Rect bounds = Rect{sx, top, right - sx, bottom - top + 1};
+    return record(DrawCommand::Op::Text, sx, sy, 0, 0, 0, bounds, text, length);
+}
+
+void Graphics::replay(const DisplayList& list, const Rect& area) {
+    DisplayList* savedRecorder = recorder;
+    int savedCamX = camX, savedCamY = camY;
+    Rect savedClip = clip;
+    bool savedLowDetail = lowDetail;
+    const Font* savedFont = font;
+
+    recorder = nullptr;
+    camX = 0;
+    camY = 0;
+    Rect target = area.intersect(Rect{0, 0, hal->getWidth(), hal->getHeight()});
+    Rect applied = Rect{0, 0, -1, -1};
+    for (size_t i = 0; i < list.getCount(); ++i) {
+        const DrawCommand& c = list.get(i);
+        if (!c.bounds.toRect().intersects(target)) continue;
+
+        // 裁剪区在相邻命令间通常不变，变化时才同步给 HAL
+        clip = c.clip.toRect().intersect(target);
+        if (clip.x != applied.x || clip.y != applied.y || clip.w != applied.w || clip.h != applied.h) {
+            applyClip();
+            applied = clip;
+        }
+        lowDetail = c.lowDetail != 0;
+
+        switch (c.op) {
+        case DrawCommand::Op::Line: drawLine(c.x, c.y, c.w, c.h); break;
+        case DrawCommand::Op::Rect: drawRect(c.x, c.y, c.w, c.h); break;
+        case DrawCommand::Op::FillRect: fillRect(c.x, c.y, c.w, c.h); break;
+        case DrawCommand::Op::Circle: drawCircle(c.x, c.y, c.w); break;
+        case DrawCommand::Op::FillCircle: fillCircle(c.x, c.y, c.w); break;
+        case DrawCommand::Op::RoundRect: drawRoundRect(c.x, c.y, c.w, c.h, c.r); break;
+        case DrawCommand::Op::Text:
+            font = c.font;
+            drawText(c.x, c.y, list.textOf(c), c.textLength);
+            break;
+        }
+    }
+
+    recorder = savedRecorder;
+    camX = savedCamX;
+    camY = savedCamY;
+    clip = savedClip;
+    applyClip();
+    lowDetail = savedLowDetail;
+    font = savedFont;
+}
+
+void Graphics::hspan(int x, int y, int w) {
+    if (y < clip.y || y >= clip.y + clip.h) return;
+    if (x < clip.x) { w -= clip.x - x; x = clip.x; }
+    if (x + w > clip.x + clip.w) w = clip.x + clip.w - x;
+    if (w <= 0) return;
+    HYDROGEN_COUNT(stats, HLine, 1);
+    HYDROGEN_COUNT(stats, Pixels, w);
+    hal->drawHLine(x, y, w, 1);
+}
+
+void Graphics::vspan(int x, int y, int h) {
+    if (x < clip.x || x >= clip.x + clip.w) return;
+    if (y < clip.y) { h -= clip.y - y; y = clip.y; }
+    if (y + h > clip.y + clip.h) h = clip.y + clip.h - y;
+    if (h <= 0) return;
+    HYDROGEN_COUNT(stats, VLine, 1);
+    HYDROGEN_COUNT(stats, Pixels, h);
+    hal->drawVLine(x, y, h, 1);
+}
+
+void Graphics::box(int x, int y, int w, int h) {
+    Rect r = Rect{x, y, w, h}.intersect(clip);
+    if (r.isEmpty()) return;
+    HYDROGEN_COUNT(stats, Fill, 1);
+    HYDROGEN_COUNT(stats, Pixels, (unsigned long)r.w * r.h);
+    hal->fillRect(r.x, r.y, r.w, r.h, 1);
+}
+
+void Graphics::blit(int x, int y, int w, int h, const uint8_t* bitmap) {
+    if (rejects(x, y, x + w - 1, y + h - 1)) return;
+
+    // 完全在裁剪区内：整块交给 HAL
+    if (x >= clip.x && y >= clip.y && x + w <= clip.x + clip.w && y + h <= clip.y + clip.h) {
+        HYDROGEN_COUNT(stats, Bitmap, 1);
+        HYDROGEN_COUNT(stats, Pixels, (unsigned long)w * h);
+        hal->drawXBM(x, y, w, h, bitmap);
+        return;
+    }
+
+    // 跨越裁剪边界：只绘制区内的行与列
+    int rowBytes = (w + 7) / 8;
+    int i0 = std::max(0, clip.x - x);
+    int i1 = std::min(w, clip.x + clip.w - x);
+    int j0 = std::max(0, clip.y - y);
+    int j1 = std::min(h, clip.y + clip.h - y);
+    for (int j = j0; j < j1; ++j) {
+        const uint8_t* row = bitmap + j * rowBytes;
+        for (int i = i0; i < i1; ++i) {
+            if (row[i >> 3] & (1 << (i & 7))) {
+                HYDROGEN_COUNT(stats, Pixel, 1);
+                HYDROGEN_COUNT(stats, Pixels, 1);
+                hal->drawPixel(x + i, y + j, 1);
+            }
+        }
+    }
+}
+
+// 向下/向上取整的整数除法 (除数为正)
+static long long floorDiv(long long a, long long b) {
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+static long long ceilDiv(long long a, long long b) {
+    return (a >= 0) ? (a + b - 1) / b : -((-a) / b);
+}
+
+void Graphics::pushClip(const Rect& r) {
+    if (clipDepth < MAX_CLIP_DEPTH) {
+        clipStack[clipDepth] = clip;
+        clip = clip.intersect(Rect{r.x - camX, r.y - camY, r.w, r.h});
+        applyClip();
+    }
+    clipDepth++;
+}
+
+void Graphics::popClip() {
+    if (clipDepth == 0) return;
+    clipDepth--;
+    if (clipDepth < MAX_CLIP_DEPTH) {
+        clip = clipStack[clipDepth];
+        applyClip();
+    }
+}
+
 void Graphics::drawLine(int x0, int y0, int x1, int y1) {
     // 转换到屏幕坐标
     x0 -= camX; y0 -= camY;
     x1 -= camX; y1 -= camY;
 
-    // Bresenham 直线算法
+    if (recorder) {
+        int left = std::min(x0, x1), top = std::min(y0, y1);
+        if (record(DrawCommand::Op::Line, x0, y0, x1, y1, 0,
+                   Rect{left, top, std::max(x0, x1) - left + 1, std::max(y0, y1) - top + 1})) return;
+    }
+
+    // 包围盒完全不可见，直接丢弃
+    if (rejects(std::min(x0, x1), std::min(y0, y1), std::max(x0, x1), std::max(y0, y1))) return;
+
+    // 水平/垂直线直接走 HAL 批量接口，避免逐点虚函数调用
+    if (y0 == y1) {
+        if (x0 > x1) std::swap(x0, x1);
+        hspan(x0, y0, x1 - x0 + 1);
+        return;
+    }
+    if (x0 == x1) {
+        if (y0 > y1) std::swap(y0, y1);
+        vspan(x0, y0, y1 - y0 + 1);
+        return;
+    }
+
+    // Bresenham 直线算法 (主轴步进形式)
+    // 沿主轴走 major 步，第 i 步的次轴偏移为 floor((2*i*minor + major) / (2*major))。
+    // 该偏移可以直接算出，因此能像 Liang–Barsky 一样先求出落在裁剪区内的
+    // 步进区间 [iStart, iEnd]，再从 iStart 开始光栅化，结果与完整绘制逐像素一致。
     int dx = std::abs(x1 - x0);
     int dy = std::abs(y1 - y0);
-    int sx = (x0 < x1) ? 1 : -1;
-    int sy = (y0 < y1) ? 1 : -1;
-    int err = dx - dy;
+    bool xMajor = dx >= dy;
+    int major = xMajor ? dx : dy;
+    int minor = xMajor ? dy : dx;
+    int ma0 = xMajor ? x0 : y0;   // 主轴起点
+    int mi0 = xMajor ? y0 : x0;   // 次轴起点
+    int maStep = xMajor ? ((x0 < x1) ? 1 : -1) : ((y0 < y1) ? 1 : -1);
+    int miStep = xMajor ? ((y0 < y1) ? 1 : -1) : ((x0 < x1) ? 1 : -1);
+    int maLo = xMajor ? clip.x : clip.y;
+    int maHi = xMajor ? clip.x + clip.w - 1 : clip.y + clip.h - 1;
+    int miLo = xMajor ? clip.y : clip.x;
+    int miHi = xMajor ? clip.y + clip.h - 1 : clip.x + clip.w - 1;
+
+    // 1. 主轴方向：ma0 + maStep * i 落在 [maLo, maHi]
+    long long iStart = 0;
+    long long iEnd = major;
+    if (maStep > 0) {
+        iStart = std::max(iStart, (long long)maLo - ma0);
+        iEnd = std::min(iEnd, (long long)maHi - ma0);
+    } else {
+        iStart = std::max(iStart, (long long)ma0 - maHi);
+        iEnd = std::min(iEnd, (long long)ma0 - maLo);
+    }
+
+    // 2. 次轴方向：偏移量随 i 单调不减，解出偏移落在 [offLo, offHi] 的 i 区间
+    long long offLo = (miStep > 0) ? miLo - mi0 : mi0 - miHi;
+    long long offHi = (miStep > 0) ? miHi - mi0 : mi0 - miLo;
+    iStart = std::max(iStart, ceilDiv(2 * offLo * major - major, 2LL * minor));
+    iEnd = std::min(iEnd, floorDiv(2 * offHi * major + major - 1, 2LL * minor));
+    if (iStart > iEnd) return;
+
+    // 3. 从 iStart 开始增量步进，区间内的点都在裁剪区内
+    long long num = 2 * iStart * minor + major;
+    int offset = (int)(num / (2LL * major));
+    int rem = (int)(num % (2LL * major));
+    int ma = ma0 + maStep * (int)iStart;
+    for (long long i = iStart; i <= iEnd; ++i) {
+        int mi = mi0 + miStep * offset;
+        HYDROGEN_COUNT(stats, Pixel, 1);
+        HYDROGEN_COUNT(stats, Pixels, 1);
+        if (xMajor) hal->drawPixel(ma, mi, 1);
+        else hal->drawPixel(mi, ma, 1);
 
-    while (true) {
-        hal->drawPixel(x0, y0, 1);
-        if (x0 == x1 && y0 == y1) break;
-        int e2 = 2 * err;
-        if (e2 > -dy) { err -= dy; x0 += sx; }
-        if (e2 < dx) { err += dx; y0 += sy; }
+        ma += maStep;
+        rem += 2 * minor;
+        if (rem >= 2 * major) {
+            rem -= 2 * major;
+            offset++;
+        }
     }
 }
 
 void Graphics::drawRect(int x, int y, int w, int h) {
-    // 使用 drawLine 绘制四条边
-    drawLine(x, y, x + w - 1, y);                 // 上
-    drawLine(x, y + h - 1, x + w - 1, y + h - 1); // 下
-    drawLine(x, y, x, y + h - 1);                 // 左
-    drawLine(x + w - 1, y, x + w - 1, y + h - 1); // 右
-}
+    if (w <= 0 || h <= 0) return;
 
-void Graphics::fillRect(int x, int y, int w, int h) {
     // 转换到屏幕坐标
     int sx = x - camX;
     int sy = y - camY;
+    if (recorder) {
+        if (record(DrawCommand::Op::Rect, sx, sy, w, h, 0, Rect{sx, sy, w, h})) return;
+    }
+    if (rejects(sx, sy, sx + w - 1, sy + h - 1)) return;
 
-    // 简单的双重循环填充（效率较低，后续可优化为扫描线算法）
-    for (int i = sx; i < sx + w; ++i) {
-        for (int j = sy; j < sy + h; ++j) {
-            hal->drawPixel(i, j, 1);
-        }
+    // 上下两条水平边 + 左右两条垂直边（垂直边不重复绘制角点）
+    hspan(sx, sy, w);                                 // 上
+    if (h > 1) hspan(sx, sy + h - 1, w);              // 下
+    if (h > 2) {
+        vspan(sx, sy + 1, h - 2);                     // 左
+        if (w > 1) vspan(sx + w - 1, sy + 1, h - 2);  // 右
     }
 }
 
+void Graphics::fillRect(int x, int y, int w, int h) {
+    if (w <= 0 || h <= 0) return;
+
+    // 转换到屏幕坐标，交给 HAL 的批量填充接口
+    if (recorder) {
+        Rect bounds = Rect{x - camX, y - camY, w, h};
+        if (record(DrawCommand::Op::FillRect, bounds.x, bounds.y, w, h, 0, bounds)) return;
+    }
+    box(x - camX, y - camY, w, h);
+}
+
 void Graphics::drawCircle(int x0, int y0, int r) {
+    if (recorder) {
+        // 简化绘制的标志随命令记录，回放时按同样的画法绘制
+        int a = std::abs(r);
+        if (record(DrawCommand::Op::Circle, x0 - camX, y0 - camY, r, 0, 0,
+                   Rect{x0 - camX - a, y0 - camY - a, 2 * a + 1, 2 * a + 1})) return;
+    }
+
     // 转换到屏幕坐标
+    if (lowDetail && r > 2) {
+        // 简化：八边形 (4 条轴向边走批量接口，4 条斜边)
+        int k = (r * 106) >> 8; // r * tan(22.5°)
+        drawLine(x0 - k, y0 - r, x0 + k, y0 - r);
+        drawLine(x0 - k, y0 + r, x0 + k, y0 + r);
+        drawLine(x0 - r, y0 - k, x0 - r, y0 + k);
+        drawLine(x0 + r, y0 - k, x0 + r, y0 + k);
+        drawLine(x0 + k, y0 - r, x0 + r, y0 - k);
+        drawLine(x0 + r, y0 + k, x0 + k, y0 + r);
+        drawLine(x0 - k, y0 + r, x0 - r, y0 + k);
+        drawLine(x0 - r, y0 - k, x0 - k, y0 - r);
+        return;
+    }
+
     x0 -= camX; y0 -= camY;
+    if (rejects(x0 - r, y0 - r, x0 + r, y0 + r)) return;
 
     // Bresenham 圆算法
     int f = 1 - r;
@@ -57,10 +344,10 @@ void Graphics::drawCircle(int x0, int y0, int r) {
     int y = r;
 
     // 绘制四个基准点
-    hal->drawPixel(x0, y0 + r, 1);
-    hal->drawPixel(x0, y0 - r, 1);
-    hal->drawPixel(x0 + r, y0, 1);
-    hal->drawPixel(x0 - r, y0, 1);
+    plot(x0, y0 + r);
+    plot(x0, y0 - r);
+    plot(x0 + r, y0);
+    plot(x0 - r, y0);
 
     while (x < y) {
         if (f >= 0) {
@@ -73,20 +360,26 @@ void Graphics::drawCircle(int x0, int y0, int r) {
         f += ddF_x;
 
         // 绘制八个象限的点
-        hal->drawPixel(x0 + x, y0 + y, 1);
-        hal->drawPixel(x0 - x, y0 + y, 1);
-        hal->drawPixel(x0 + x, y0 - y, 1);
-        hal->drawPixel(x0 - x, y0 - y, 1);
-        hal->drawPixel(x0 + y, y0 + x, 1);
-        hal->drawPixel(x0 - y, y0 + x, 1);
-        hal->drawPixel(x0 + y, y0 - x, 1);
-        hal->drawPixel(x0 - y, y0 - x, 1);
+        plot(x0 + x, y0 + y);
+        plot(x0 - x, y0 + y);
+        plot(x0 + x, y0 - y);
+        plot(x0 - x, y0 - y);
+        plot(x0 + y, y0 + x);
+        plot(x0 - y, y0 + x);
+        plot(x0 + y, y0 - x);
+        plot(x0 - y, y0 - x);
     }
 }
 
 void Graphics::fillCircle(int x0, int y0, int r) {
     // 转换到屏幕坐标
     x0 -= camX; y0 -= camY;
+    if (recorder) {
+        int a = std::abs(r);
+        Rect bounds = Rect{x0 - a, y0 - a, 2 * a + 1, 2 * a + 1};
+        if (record(DrawCommand::Op::FillCircle, x0, y0, r, 0, 0, bounds)) return;
+    }
+    if (rejects(x0 - r, y0 - r, x0 + r, y0 + r)) return;
 
     // 使用 Bresenham 算法生成圆周点，并用水平线填充
     int f = 1 - r;
@@ -96,10 +389,10 @@ void Graphics::fillCircle(int x0, int y0, int r) {
     int y = r;
 
     // 中心线
-    hal->drawPixel(x0, y0 + r, 1);
-    hal->drawPixel(x0, y0 - r, 1);
+    plot(x0, y0 + r);
+    plot(x0, y0 - r);
     // 水平线填充 (中心)
-    for (int i = x0 - r; i <= x0 + r; ++i) hal->drawPixel(i, y0, 1);
+    hspan(x0 - r, y0, 2 * r + 1);
 
     while (x < y) {
         if (f >= 0) {
@@ -112,18 +405,36 @@ void Graphics::fillCircle(int x0, int y0, int r) {
         f += ddF_x;
 
         // 填充水平线
-        for (int i = x0 - x; i <= x0 + x; ++i) {
-            hal->drawPixel(i, y0 + y, 1);
-            hal->drawPixel(i, y0 - y, 1);
-        }
-        for (int i = x0 - y; i <= x0 + y; ++i) {
-            hal->drawPixel(i, y0 + x, 1);
-            hal->drawPixel(i, y0 - x, 1);
-        }
+        hspan(x0 - x, y0 + y, 2 * x + 1);
+        hspan(x0 - x, y0 - y, 2 * x + 1);
+        hspan(x0 - y, y0 + x, 2 * y + 1);
+        hspan(x0 - y, y0 - x, 2 * y + 1);
     }
 }
 
 void Graphics::drawRoundRect(int x, int y, int w, int h, int r) {
+    if (recorder) {
+        // 半径超过边长一半 (或宽高不为正) 时边与圆角会画到 {x, y, w, h} 之外，
+        // 包围盒取各条边与圆心所有可能的端点
+        int sx = x - camX, sy = y - camY;
+        int xs[] = {sx, sx + 1, sx + r, sx + w - r - 1, sx + w - 2, sx + w - 1};
+        int ys[] = {sy, sy + 1, sy + r, sy + h - r - 1, sy + h - 2, sy + h - 1};
+        int x0 = *std::min_element(xs, xs + 6), x1 = *std::max_element(xs, xs + 6);
+        int y0 = *std::min_element(ys, ys + 6), y1 = *std::max_element(ys, ys + 6);
+        Rect bounds = Rect{x0, y0, x1 - x0 + 1, y1 - y0 + 1};
+        if (record(DrawCommand::Op::RoundRect, sx, sy, w, h, r, bounds)) return;
+    }
+    if (rejects(x - camX, y - camY, x - camX + w - 1, y - camY + h - 1)) return;
+
+    if (lowDetail && r > 1) {
+        // 简化：圆角退化为 1px 切角，只剩四条边
+        drawLine(x + 1, y, x + w - 2, y);
+        drawLine(x + 1, y + h - 1, x + w - 2, y + h - 1);
+        drawLine(x, y + 1, x, y + h - 2);
+        drawLine(x + w - 1, y + 1, x + w - 1, y + h - 2);
+        return;
+    }
+
     // 绘制四条直线边（留出圆角空间）
     drawLine(x + r, y, x + w - r - 1, y);                 // 上
     drawLine(x + r, y + h - 1, x + w - r - 1, y + h - 1); // 下
@@ -143,10 +454,10 @@ void Graphics::drawRoundRect(int x, int y, int w, int h, int r) {
     // 辅助 lambda：绘制相对于圆心的点（自动处理相机偏移）
     auto drawCorner = [&](int cx, int cy, int px, int py, int q) {
         cx -= camX; cy -= camY;
-        if (q == 0) hal->drawPixel(cx - px, cy - py, 1); // 左上象限
-        if (q == 1) hal->drawPixel(cx + px, cy - py, 1); // 右上象限
-        if (q == 2) hal->drawPixel(cx - px, cy + py, 1); // 左下象限
-        if (q == 3) hal->drawPixel(cx + px, cy + py, 1); // 右下象限
+        if (q == 0) plot(cx - px, cy - py); // 左上象限
+        if (q == 1) plot(cx + px, cy - py); // 右上象限
+        if (q == 2) plot(cx - px, cy + py); // 左下象限
+        if (q == 3) plot(cx + px, cy + py); // 右下象限
     };
 
     int f = 1 - r;
@@ -179,9 +490,53 @@ void Graphics::drawRoundRect(int x, int y, int w, int h, int r) {
     }
 }
 
-void Graphics::drawText(int x, int y, const std::string& text) {
-    // 转换到屏幕坐标并调用 HAL 绘制
-    hal->drawStr(x - camX, y - camY, text.c_str());
+bool Graphics::drawNativeText(int sx, int sy, const char* text, const char* end) {
+    if (!font) {
+        // 不知道字体度量，按保守的字高估计做粗略剔除：
+        // 文本从 x 向右延伸，基线以上最多 32px，基线以下最多 8px
+        return rejects(sx, sy - 32, sx + 0x7FFF, sy + 8);
+    }
+
+    // 原生字体：逐字解码并块传输字形位图
+    if (rejects(sx, sy - font->ascent, sx + 0x7FFF, sy + font->descent)) return true;
+    int right = clip.x + clip.w;
+    const char* p = text;
+    while (end ? p < end : *p != '\0') {
+        // 字形相对笔位的偏移不小于 -128，笔位足够靠右后剩下的字都不可见
+        if (sx > right + 128) break;
+        const FontGlyph* g = font->glyphFor(decodeUtf8(p, end));
+        if (!g) continue;
+        if (g->width && g->height) {
+            blit(sx + g->x, sy + g->y, g->width, g->height, font->bitmaps + g->offset);
+        }
+        sx += g->advance;
+    }
+    return true;
+}
+
+void Graphics::drawText(int x, int y, const char* text) {
+    // 转换到屏幕坐标
+    int sx = x - camX;
+    int sy = y - camY;
+    if (recorder) {
+        if (recordText(sx, sy, text, strlen(text))) return;
+    }
+    if (drawNativeText(sx, sy, text, nullptr)) return;
+
+    // 调用 HAL 绘制 (HAL 自身负责按 setClipWindow 裁剪)
+    HYDROGEN_COUNT(stats, Str, 1);
+    hal->drawStr(sx, sy, text);
+}
+
+void Graphics::drawText(int x, int y, const char* text, size_t length) {
+    int sx = x - camX;
+    int sy = y - camY;
+    if (recorder) {
+        if (recordText(sx, sy, text, length)) return;
+    }
+    if (drawNativeText(sx, sy, text, text + length)) return;
+    HYDROGEN_COUNT(stats, Str, 1);
+    hal->drawStrN(sx, sy, text, length);
 }
 
 } // namespace Hydrogen
@@ -1,23 +1,14 @@
 #pragma once
 #include "../hal/hal.h"
+#include "text_cache.h"
+#include "font.h"
+#include "geometry.h"
+#include "display_list.h"
+#include "stats.h"
 #include <string>
 
 namespace Hydrogen {
 
-/**
- * @brief 2D 坐标点结构
- */
-struct Point {
-    int x, y;
-};
-
-/**
- * @brief 矩形区域结构
- */
-struct Rect {
-    int x, y, w, h;
-};
-
 /**
  * @brief 核心图形引擎
  *
@@ -27,18 +18,106 @@ struct Rect {
  * @note 坐标系统：
  * Graphics 内部会自动处理“世界坐标”到“屏幕坐标”的转换。
  * 绘图时传入的是世界坐标，Graphics 会自动减去 Camera 的偏移量。
+ * translate() 可以再叠加一个原点偏移，用于绘制以父控件为原点的子控件。
+ *
+ * @note 裁剪：
+ * 所有图元都会被裁剪到当前裁剪区域（默认即屏幕范围）。
+ * 包围盒完全落在裁剪区外的图元直接丢弃，直线在光栅化前先求出可见区间，
+ * 填充扫描线按裁剪区截断，因此屏幕外的部分几乎没有开销。
+ *
+ * @note 录制：
+ * beginRecording() 之后图元只记录到显示列表 (DisplayList)，由 replay() 稍后光栅化。
+ * 列表溢出时可由回调清屏，已录制的命令立即回放，之后的图元直接绘制。
  */
 class Graphics {
+public:
+    static const int MAX_CLIP_DEPTH = 8; ///< 裁剪栈最大深度
+
+    typedef void (*OverflowHandler)(void* user);
+
 protected:
     HAL* hal;
-    int camX, camY;
+    int camX, camY;                     ///< 相机位置减去原点偏移，绘图时直接减去它得到屏幕坐标
+    int originX, originY;               ///< translate() 叠加的原点偏移
+    Rect clip;                          ///< 当前裁剪区域 (屏幕坐标)
+    Rect clipStack[MAX_CLIP_DEPTH];     ///< 被 pushClip 保存的外层裁剪区域
+    int clipDepth;                      ///< 当前嵌套深度 (可能超过 MAX_CLIP_DEPTH)
+    bool lowDetail;                     ///< 简化圆角/圆形 (由 FrameGovernor 降级时开启)
+    TextWidthCache textCache;           ///< 文本宽度缓存
+    const Font* font;                   ///< 原生字体，nullptr 时文本交给 HAL 绘制
+    DisplayList* recorder;              ///< 正在录制的显示列表，nullptr 表示立即绘制
+    OverflowHandler overflowHandler;    ///< 列表溢出时在回放已录制部分之前调用 (清除录制区域)
+    void* overflowUser;
+#if HYDROGEN_ENABLE_STATS
+    FrameStats* stats;                  ///< HAL 调用计数，nullptr 表示不统计
+#endif
+
+    /**
+     * @brief 包围盒 (屏幕坐标，闭区间) 是否完全在裁剪区之外
+     */
+    bool rejects(int x0, int y0, int x1, int y1) const {
+        return x1 < clip.x || y1 < clip.y || x0 >= clip.x + clip.w || y0 >= clip.y + clip.h;
+    }
+
+    /**
+     * @brief 裁剪区域变化后同步给 HAL (用于 HAL 自身绘制的文本)
+     */
+    void applyClip() {
+        hal->setClipWindow(clip.x, clip.y, clip.w, clip.h);
+    }
+
+    // 带裁剪的底层光栅操作 (屏幕坐标)
+    void plot(int x, int y) {
+        if (x < clip.x || y < clip.y || x >= clip.x + clip.w || y >= clip.y + clip.h) return;
+        HYDROGEN_COUNT(stats, Pixel, 1);
+        HYDROGEN_COUNT(stats, Pixels, 1);
+        hal->drawPixel(x, y, 1);
+    }
+    void hspan(int x, int y, int w);
+    void vspan(int x, int y, int h);
+    void box(int x, int y, int w, int h);
+    void blit(int x, int y, int w, int h, const uint8_t* bitmap);
+
+    /**
+     * @brief 文本绘制的公共部分：剔除与原生字体渲染
+     * @param end 文本末尾，nullptr 表示以 '\0' 结尾
+     * @return 文本已处理完毕 (被剔除或已用原生字体绘制)，否则需交给 HAL 绘制
+     */
+    bool drawNativeText(int sx, int sy, const char* text, const char* end);
+
+    /**
+     * @brief 把一条图元追加到显示列表 (坐标为屏幕坐标)
+     * 包围盒与裁剪区不相交的图元不记录；坐标超出 16 位时列表标记为溢出。
+     * @return false 表示列表溢出、已转为直接绘制，调用方接着光栅化这条图元
+     */
+    bool record(DrawCommand::Op op, int x, int y, int w, int h, int r, const Rect& bounds,
+                const char* text = nullptr, size_t length = 0);
+
+    /**
+     * @brief 录制文本，包围盒按字体度量 (HAL 字体按保守的字高) 估计，向右延伸到裁剪区边缘
+     * @return 同 record()
+     */
+    bool recordText(int sx, int sy, const char* text, size_t length);
+
+    /**
+     * @brief 列表溢出后停止录制：调用 overflowHandler，回放已录制的命令
+     * @return 已转为直接绘制；没有设置回调时返回 false，列表只标记溢出
+     */
+    bool overflowToDirect();
 
 public:
     /**
      * @brief 构造函数
      * @param hal 硬件抽象层实例
      */
-    explicit Graphics(HAL* hal) : hal(hal), camX(0), camY(0) {}
+    explicit Graphics(HAL* hal)
+        : hal(hal), camX(0), camY(0), originX(0), originY(0), clipDepth(0), lowDetail(false), font(nullptr),
+          recorder(nullptr), overflowHandler(nullptr), overflowUser(nullptr) {
+#if HYDROGEN_ENABLE_STATS
+        stats = nullptr;
+#endif
+        resetClip();
+    }
 
     /**
      * @brief 设置相机位置
@@ -46,15 +125,87 @@ public:
      * @param y 相机左上角 Y 坐标
      */
     void setCamera(int x, int y) {
-        camX = x;
-        camY = y;
+        camX = x - originX;
+        camY = y - originY;
     }
 
-    int getCamX() const { return camX; }
-    int getCamY() const { return camY; }
+    int getCamX() const { return camX + originX; }
+    int getCamY() const { return camY + originY; }
+
+    /**
+     * @brief 平移坐标原点
+     * 之后的绘图坐标、isVisible() 与 pushClip() 都相对于新的原点，必须以相反的偏移调用一次来恢复。
+     * @param dx 原点 X 方向的偏移
+     * @param dy 原点 Y 方向的偏移
+     */
+    void translate(int dx, int dy) {
+        originX += dx;
+        originY += dy;
+        camX -= dx;
+        camY -= dy;
+    }
+
+    int getOriginX() const { return originX; }
+    int getOriginY() const { return originY; }
+
+    /**
+     * @brief 设置基础裁剪区域
+     * 之后的图形绘制只会影响该区域内的像素。用于局部重绘。
+     * 会清空裁剪栈。
+     * @param r 裁剪矩形 (屏幕坐标)，会自动与屏幕范围求交
+     */
+    void setClip(const Rect& r) {
+        clip = r.intersect(Rect{0, 0, hal->getWidth(), hal->getHeight()});
+        clipDepth = 0;
+        applyClip();
+    }
+
+    /**
+     * @brief 恢复为全屏裁剪，并清空裁剪栈
+     */
+    void resetClip() {
+        clip = Rect{0, 0, hal->getWidth(), hal->getHeight()};
+        clipDepth = 0;
+        applyClip();
+    }
+
+    /**
+     * @brief 压入裁剪区域
+     * 新的裁剪区域为当前区域与 r 的交集，必须与 popClip() 成对调用。
+     * 嵌套超过 MAX_CLIP_DEPTH 时不再收窄，仅保持配对计数。
+     * @param r 裁剪矩形 (世界坐标)
+     */
+    void pushClip(const Rect& r);
+
+    /**
+     * @brief 弹出裁剪区域，恢复到对应 pushClip() 之前的状态
+     */
+    void popClip();
+
+    /**
+     * @brief 判断矩形 (当前原点下的坐标) 是否与当前裁剪区域相交
+     * 控件可据此跳过完全不可见的内容。
+     */
+    bool isVisible(const Rect& r) const {
+        return !rejects(r.x - camX, r.y - camY, r.x - camX + r.w - 1, r.y - camY + r.h - 1) && !r.isEmpty();
+    }
+
+    /**
+     * @brief 获取当前裁剪区域 (屏幕坐标)
+     */
+    Rect getClip() const { return clip; }
+
+    /**
+     * @brief 开启/关闭简化绘制
+     * 开启后空心圆绘制为八边形，圆角矩形的圆角只保留 1px 切角，
+     * 以更少的逐点操作换取速度。
+     */
+    void setLowDetail(bool low) { lowDetail = low; }
+    bool isLowDetail() const { return lowDetail; }
 
     /**
      * @brief 绘制直线 (Bresenham 算法)
+     * 先按裁剪区求出可见的步进区间再光栅化，结果与不裁剪时逐像素一致。
      */
     void drawLine(int x0, int y0, int x1, int y1);
 
@@ -90,11 +241,81 @@ public:
      */
     void drawRoundRect(int x, int y, int w, int h, int r);
 
+    /**
+     * @brief 设置原生字体
+     * 设置后 drawText/getTextWidth 使用该字体，字形经 HAL::drawXBM 绘制，
+     * 因此任何 HAL (帧缓冲、TFT 等) 都能显示文本。
+     * @param f 字体 (需在使用期间保持有效)，nullptr 表示改回 HAL 自带的字体
+     */
+    void setFont(const Font* f) { font = f; }
+    const Font* getFont() const { return font; }
+
     /**
      * @brief 绘制文本
+     * 文本只被读取，不会复制到堆上，可直接传入字符串常量或栈上的缓冲区。
+     * @param y 基线位置
      * @param text 支持 UTF-8 字符串
      */
-    void drawText(int x, int y, const std::string& text);
+    void drawText(int x, int y, const char* text);
+
+    /**
+     * @brief 绘制文本的前 length 字节 (文本无需以 '\0' 结尾)
+     */
+    void drawText(int x, int y, const char* text, size_t length);
+
+    void drawText(int x, int y, const std::string& text) { drawText(x, y, text.c_str()); }
+
+    /**
+     * @brief 获取文本的显示宽度 (带缓存)
+     * 控件应使用此接口而不是直接调用 HAL::getStrWidth()。
+     */
+    int getTextWidth(const char* text) { return textCache.measure(hal, font, text); }
+    int getTextWidth(const char* text, size_t length) { return textCache.measure(hal, font, text, length); }
+    int getTextWidth(const std::string& text) { return textCache.measure(hal, font, text.c_str()); }
+
+    /**
+     * @brief 开始录制：之后的图元追加到显示列表，不再立即光栅化
+     * 录制区域为当前裁剪区域。
+     * @param onOverflow 列表溢出时调用 (应清除录制区域)，之后已录制的命令立即回放、其余图元直接绘制，
+     *                   isRecording() 随之返回 false；nullptr 表示溢出后只标记列表，由调用方处理
+     */
+    void beginRecording(DisplayList* list, OverflowHandler onOverflow = nullptr, void* user = nullptr) {
+        recorder = list;
+        overflowHandler = onOverflow;
+        overflowUser = user;
+        list->begin(clip);
+    }
+
+    /**
+     * @brief 结束录制，恢复立即绘制
+     */
+    void endRecording() {
+        if (recorder) recorder->end();
+        recorder = nullptr;
+    }
+
+    bool isRecording() const { return recorder != nullptr; }
+
+    /**
+     * @brief 把显示列表回放到本图形上下文的 HAL
+     * 只执行包围盒与 area 相交的命令，每条命令裁剪到其录制时的裁剪区与 area 的交集。
+     * 相机、裁剪区域、字体与简化绘制的设置在回放后恢复。
+     * area 小于录制区域时，半径超过边长一半的圆角矩形按 drawRoundRect 自身的剔除规则可能少画几个点。
+     * @param area 回放区域 (屏幕坐标)，如一个分块或一个 U8g2 页
+     */
+    void replay(const DisplayList& list, const Rect& area);
+
+#if HYDROGEN_ENABLE_STATS
+    /**
+     * @brief 把 HAL 调用计入帧统计 (由 Application 设置)
+     */
+    void setStats(FrameStats* s) { stats = s; }
+#endif
+
+    /**
+     * @brief 获取文本宽度缓存 (命中统计、手动清空)
+     */
+    TextWidthCache& getTextCache() { return textCache; }
 
     /**
      * @brief 获取底层 HAL 实例
@@ -0,0 +1,95 @@
+#pragma once
+#include "stats.h"
+#include <stdint.h>
+#include <atomic>
+
+namespace Hydrogen {
+
+/**
+ * @brief 输入事件
+ * 由中断或输入任务通过 Application::postEvent() 投递，在下一次 Application::update() 开始时分发。
+ */
+struct InputEvent {
+    enum class Type : uint8_t {
+        Encoder,    ///< 编码器旋转，delta 为步数 (顺时针为正)
+        ButtonDown, ///< 按键按下，id 为按键编号
+        ButtonUp,   ///< 按键松开
+        LongPress   ///< 长按
+    };
+
+    Type type;
+    uint8_t id;             ///< 按键编号 (编码器事件为编码器编号)
+    int16_t delta;          ///< 编码器步数
+    unsigned long stampUs;  ///< 投递时间 (HAL::getMicros())，由 postEvent() 填写
+
+    static InputEvent encoder(int delta, uint8_t id = 0) {
+        InputEvent e = {Type::Encoder, id, (int16_t)delta, 0};
+        return e;
+    }
+
+    static InputEvent button(Type type, uint8_t id = 0) {
+        InputEvent e = {type, id, 0, 0};
+        return e;
+    }
+};
+
+/**
+ * @brief 单生产者/单消费者的无锁事件队列
+ *
+ * 生产者 (中断或另一个任务) 调用 push()，消费者 (UI 主循环) 调用 pop()，两边都不加锁。
+ * 队列满时新事件被丢弃并计数，不会阻塞中断。
+ */
+class InputQueue {
+public:
+    static const uint32_t CAPACITY = 32; ///< 容量 (2 的幂)
+
+private:
+    InputEvent events[CAPACITY];
+    std::atomic<uint32_t> head;    ///< 生产者的写入计数
+    std::atomic<uint32_t> tail;    ///< 消费者的读取计数
+    std::atomic<uint32_t> dropped; ///< 因队列已满丢弃的事件数
+
+public:
+    InputQueue() : head(0), tail(0), dropped(0) {}
+
+    /**
+     * @brief 投递事件 (生产者，可在中断中调用)
+     * @return 队列已满时返回 false
+     */
+    bool push(const InputEvent& e) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= CAPACITY) {
+            // 只有生产者修改 dropped，不需要原子的读-改-写
+            dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        events[h & (CAPACITY - 1)] = e;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 取出最早的事件 (消费者)
+     * @return 队列为空时返回 false
+     */
+    bool pop(InputEvent& e) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        e = events[t & (CAPACITY - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool isEmpty() const {
+        return tail.load(std::memory_order_relaxed) == head.load(std::memory_order_acquire);
+    }
+
+    uint32_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief 延迟统计 (微秒)：最近 64 个样本的滚动窗口，读取 percentile(50)、percentile(99) 等
+ */
+typedef RollingWindow<64> LatencyStats;
+
+} // namespace Hydrogen
@@ -0,0 +1,170 @@
+#include "stats.h"
+#include "format.h"
+#include <string.h>
+
+namespace Hydrogen {
+
+void FrameStats::clearCosts(WidgetCost* list) {
+    for (int i = 0; i < TOP_WIDGETS; ++i) list[i] = WidgetCost{nullptr, Rect{0, 0, 0, 0}, 0};
+}
+
+void FrameStats::insert(WidgetCost* list, const WidgetCost& cost) {
+    // 同一控件只保留一项：已有更高的记录时忽略，否则先移除旧记录
+    int end = TOP_WIDGETS;
+    for (int i = 0; i < TOP_WIDGETS && list[i].widget; ++i) {
+        if (list[i].widget != cost.widget) continue;
+        if (list[i].us >= cost.us) return;
+        end = i;
+        break;
+    }
+    int pos = 0;
+    while (pos < end && list[pos].widget && list[pos].us >= cost.us) pos++;
+    if (pos >= end) return;
+    // 把 [pos, end) 后移一位 (end 为 TOP_WIDGETS 时挤掉最后一项)
+    int last = end < TOP_WIDGETS ? end : TOP_WIDGETS - 1;
+    for (int i = last; i > pos; --i) list[i] = list[i - 1];
+    list[pos] = cost;
+}
+
+void FrameStats::reset() {
+    for (int i = 0; i < (int)Phase::Count; ++i) {
+        phases[i].reset();
+        phaseUs[i] = 0;
+    }
+    for (int i = 0; i < (int)Counter::Count; ++i) {
+        counters[i].reset();
+        counts[i] = 0;
+    }
+    clearCosts(frameTop);
+    clearCosts(lastTop);
+    clearCosts(hot);
+    frames = 0;
+    lastEndUs = 0;
+    hasLastEnd = false;
+}
+
+void FrameStats::beginFrame(unsigned long startUs) {
+    if (hasLastEnd) phaseUs[(int)Phase::Idle] += startUs - lastEndUs;
+}
+
+void FrameStats::endFrame(unsigned long endUs) {
+    for (int i = 0; i < (int)Phase::Count; ++i) {
+        phases[i].record(phaseUs[i]);
+        phaseUs[i] = 0;
+    }
+    for (int i = 0; i < (int)Counter::Count; ++i) {
+        counters[i].record(counts[i]);
+        counts[i] = 0;
+    }
+    for (int i = 0; i < TOP_WIDGETS; ++i) lastTop[i] = frameTop[i];
+    clearCosts(frameTop);
+    frames++;
+    lastEndUs = endUs;
+    hasLastEnd = true;
+}
+
+void FrameStats::recordWidget(const Widget* w, const Rect& bounds, unsigned long us) {
+    WidgetCost cost{w, bounds, us};
+    insert(frameTop, cost);
+    insert(hot, cost);
+}
+
+const char* FrameStats::phaseName(Phase p) {
+    static const char* const names[] = {"update", "clear", "draw", "flush", "idle"};
+    return p < Phase::Count ? names[(int)p] : "?";
+}
+
+const char* FrameStats::counterName(Counter c) {
+    static const char* const names[] = {"pixel", "hline", "vline", "fill", "bitmap",
+                                        "str", "strWidth", "pixels", "bytes"};
+    return c < Counter::Count ? names[(int)c] : "?";
+}
+
+namespace {
+
+const size_t NAME_WIDTH = 9;
+const size_t COLUMN_WIDTH = 8;
+
+void pad(TextBuilder& out, size_t width) {
+    while (out.length() < width) out.append(' ');
+}
+
+void appendColumn(TextBuilder& out, const char* text) {
+    pad(out, out.length() + COLUMN_WIDTH - strlen(text));
+    out.append(text);
+}
+
+void appendColumn(TextBuilder& out, unsigned long value) {
+    char digits[12];
+    TextBuilder(digits, sizeof(digits)).append(value);
+    appendColumn(out, digits);
+}
+
+void appendHeader(TextBuilder& out, const char* title) {
+    out.clear();
+    out.append(title);
+    pad(out, NAME_WIDTH);
+    appendColumn(out, "min");
+    appendColumn(out, "avg");
+    appendColumn(out, "max");
+    appendColumn(out, "p99");
+}
+
+void appendRow(TextBuilder& out, const char* name, const RollingStats& s) {
+    out.clear();
+    out.append(name);
+    pad(out, NAME_WIDTH);
+    appendColumn(out, s.getMin());
+    appendColumn(out, s.getAvg());
+    appendColumn(out, s.getMax());
+    appendColumn(out, s.percentile(99));
+}
+
+void appendCost(TextBuilder& out, int rank, const FrameStats::WidgetCost& c) {
+    out.clear();
+    out.append("  #").append(rank).append(' ').append(c.us).append("us at (");
+    out.append(c.bounds.x).append(',').append(c.bounds.y).append(") ");
+    out.append(c.bounds.w).append('x').append(c.bounds.h);
+}
+
+} // namespace
+
+void FrameStats::dump(LineWriter write, void* user) const {
+    char line[64];
+    TextBuilder out(line, sizeof(line));
+
+    out.append("frames ").append(frames).append(" (window ").append(RollingStats::WINDOW).append(')');
+    write(line, user);
+
+    appendHeader(out, "us");
+    write(line, user);
+    for (int i = 0; i < (int)Phase::Count; ++i) {
+        appendRow(out, phaseName((Phase)i), phases[i]);
+        write(line, user);
+    }
+
+    appendHeader(out, "count");
+    write(line, user);
+    for (int i = 0; i < (int)Counter::Count; ++i) {
+        appendRow(out, counterName((Counter)i), counters[i]);
+        write(line, user);
+    }
+
+    out.clear();
+    out.append("last frame widgets (self draw time)");
+    write(line, user);
+    for (int i = 0; i < TOP_WIDGETS && lastTop[i].widget; ++i) {
+        appendCost(out, i + 1, lastTop[i]);
+        write(line, user);
+    }
+
+    out.clear();
+    out.append("hottest widgets since reset");
+    write(line, user);
+    for (int i = 0; i < TOP_WIDGETS && hot[i].widget; ++i) {
+        appendCost(out, i + 1, hot[i]);
+        write(line, user);
+    }
+}
+
+} // namespace Hydrogen
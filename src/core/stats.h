@@ -0,0 +1,238 @@
+#pragma once
+#include "geometry.h"
+#include <algorithm>
+#include <stdint.h>
+
+/**
+ * @brief 是否收集帧统计 (FrameStats)
+ *
+ * 默认关闭：Application、Graphics 中的计时与计数全部在编译期去掉，不占用内存也没有运行开销。
+ * 需要在现场定位热点控件时以 -DHYDROGEN_ENABLE_STATS=1 编译，之后通过 App.getStats() 读取。
+ */
+#ifndef HYDROGEN_ENABLE_STATS
+#define HYDROGEN_ENABLE_STATS 0
+#endif
+
+/**
+ * @brief 滚动窗口的样本数 (每个统计量占用 4 * 此值字节)
+ */
+#ifndef HYDROGEN_STATS_WINDOW
+#define HYDROGEN_STATS_WINDOW 32
+#endif
+
+/**
+ * @brief 计入一次统计 (关闭统计时展开为空语句，参数不会被求值)
+ */
+#if HYDROGEN_ENABLE_STATS
+#define HYDROGEN_COUNT(stats, counter, n) \
+    do { if (stats) (stats)->count(::Hydrogen::FrameStats::Counter::counter, (n)); } while (0)
+#else
+#define HYDROGEN_COUNT(stats, counter, n) do {} while (0)
+#endif
+
+namespace Hydrogen {
+
+class Widget;
+
+/**
+ * @brief 滚动窗口统计：保留最近 N 个样本，按需计算最小/平均/最大值与百分位数
+ * 帧统计 (RollingStats) 与输入延迟 (LatencyStats) 共用这一实现，只是窗口大小不同。
+ */
+template <int N>
+class RollingWindow {
+public:
+    static const int WINDOW = N;
+
+private:
+    uint32_t samples[N];
+    unsigned long count; ///< 累计样本数
+
+    int size() const { return count < (unsigned long)N ? (int)count : N; }
+
+public:
+    RollingWindow() : count(0) {}
+
+    void record(unsigned long value) {
+        samples[count % N] = (uint32_t)value;
+        count++;
+    }
+
+    void reset() { count = 0; }
+
+    unsigned long getCount() const { return count; }
+
+    /**
+     * @brief 最近一个样本，没有样本时为 0
+     */
+    unsigned long getLast() const { return count ? samples[(count - 1) % N] : 0; }
+
+    unsigned long getMin() const {
+        int n = size();
+        return n ? *std::min_element(samples, samples + n) : 0;
+    }
+
+    unsigned long getMax() const {
+        int n = size();
+        return n ? *std::max_element(samples, samples + n) : 0;
+    }
+
+    unsigned long getAvg() const {
+        int n = size();
+        if (n == 0) return 0;
+        unsigned long long sum = 0;
+        for (int i = 0; i < n; ++i) sum += samples[i];
+        return (unsigned long)((sum + n / 2) / n);
+    }
+
+    /**
+     * @brief 窗口内样本的百分位数 (最近秩法)
+     * @param p 百分位 (1 ~ 100)，如 99
+     */
+    unsigned long percentile(int p) const {
+        int n = size();
+        if (n == 0) return 0;
+        if (p < 1) p = 1;
+        if (p > 100) p = 100;
+
+        uint32_t sorted[N];
+        std::copy(samples, samples + n, sorted);
+        int k = (p * n + 99) / 100 - 1;
+        std::nth_element(sorted, sorted + k, sorted + n);
+        return sorted[k];
+    }
+};
+
+/**
+ * @brief 帧统计的滚动窗口 (HYDROGEN_STATS_WINDOW 个样本)
+ */
+typedef RollingWindow<HYDROGEN_STATS_WINDOW> RollingStats;
+
+/**
+ * @brief 逐帧统计：各阶段耗时、HAL 调用次数、最耗时的控件
+ *
+ * Application 每绘制一帧 (有脏区域、进入清屏与绘制的帧) 更新一次，各项按帧计入滚动窗口。
+ * 阶段耗时以微秒计：
+ * - Update：分发输入与逻辑步长 (补间，包括相机的平滑滚动，以及控件 update)
+ * - Clear：清除脏区域
+ * - Draw：绘制控件 (设置显示列表时包括录制与回放)
+ * - Flush：推送到屏幕 (异步刷新时只是发起传输及等待上一帧)
+ * - Idle：上一帧结束到本帧开始之间，主循环花在界面之外的时间 (包括画面无变化而跳过的 update)
+ *
+ * HAL 调用按类型计数，像素数为图元触及的像素 (不含 HAL 字体绘制的文本)，
+ * 刷新字节数按 1bpp 页布局估算 (帧差分之前)。
+ *
+ * 控件耗时只计控件自身的 draw()，不含子控件。
+ *
+ * @code
+ *   // 串口输出 (Arduino)
+ *   App.getStats().dump([](const char* line, void*) { Serial.println(line); });
+ * @endcode
+ */
+class FrameStats {
+public:
+    enum class Phase : uint8_t { Update, Clear, Draw, Flush, Idle, Count };
+
+    enum class Counter : uint8_t {
+        Pixel,     ///< drawPixel
+        HLine,     ///< drawHLine
+        VLine,     ///< drawVLine
+        Fill,      ///< fillRect / clear
+        Bitmap,    ///< drawXBM
+        Str,       ///< drawStr / drawStrN
+        StrWidth,  ///< getStrWidth / getStrWidthN (文本宽度缓存未命中)
+        Pixels,    ///< 触及的像素数
+        Bytes,     ///< 刷新的字节数
+        Count
+    };
+
+    static const int TOP_WIDGETS = 4; ///< 记录的最耗时控件数
+
+    /**
+     * @brief 一次控件绘制的耗时
+     * widget 只用于识别 (控件可能已被删除，不要解引用)，bounds 为绘制时控件相对父控件的边界。
+     */
+    struct WidgetCost {
+        const Widget* widget;
+        Rect bounds;
+        unsigned long us;
+    };
+
+    /**
+     * @brief 逐行输出文本 (不含换行符)
+     */
+    typedef void (*LineWriter)(const char* line, void* user);
+
+private:
+    RollingStats phases[(int)Phase::Count];
+    RollingStats counters[(int)Counter::Count];
+    unsigned long phaseUs[(int)Phase::Count];     ///< 当前帧各阶段的累计
+    unsigned long counts[(int)Counter::Count];    ///< 当前帧各计数的累计
+    WidgetCost frameTop[TOP_WIDGETS];             ///< 当前帧最耗时的控件 (按耗时降序)
+    WidgetCost lastTop[TOP_WIDGETS];              ///< 上一帧最耗时的控件
+    WidgetCost hot[TOP_WIDGETS];                  ///< 重置以来单次绘制耗时最多的控件
+    unsigned long frames;
+    unsigned long lastEndUs;                      ///< 上一帧结束的时间
+    bool hasLastEnd;
+
+    /**
+     * @brief 按耗时降序插入 (每个控件只保留耗时最多的一项)
+     */
+    static void insert(WidgetCost* list, const WidgetCost& cost);
+    static void clearCosts(WidgetCost* list);
+
+public:
+    FrameStats() { reset(); }
+
+    /**
+     * @brief 清空所有统计
+     */
+    void reset();
+
+    /**
+     * @brief 开始新的一帧 (由 Application 调用)
+     * @param startUs 本帧开始的时间，与上一帧结束之间的间隔计入 Idle
+     */
+    void beginFrame(unsigned long startUs);
+
+    /**
+     * @brief 结束一帧：当前帧的各项计入滚动窗口
+     */
+    void endFrame(unsigned long endUs);
+
+    void addPhase(Phase p, unsigned long us) { phaseUs[(int)p] += us; }
+    void count(Counter c, unsigned long n) { counts[(int)c] += n; }
+
+    /**
+     * @brief 记录一个控件的绘制耗时
+     */
+    void recordWidget(const Widget* w, const Rect& bounds, unsigned long us);
+
+    const RollingStats& getPhase(Phase p) const { return phases[(int)p]; }
+    const RollingStats& getCounter(Counter c) const { return counters[(int)c]; }
+
+    /**
+     * @brief 上一帧最耗时的控件 (TOP_WIDGETS 项，按耗时降序，空位的 widget 为 nullptr)
+     */
+    const WidgetCost* getFrameTop() const { return lastTop; }
+
+    /**
+     * @brief 重置以来单次绘制耗时最多的控件 (每个控件只出现一次)
+     */
+    const WidgetCost* getHotWidgets() const { return hot; }
+
+    /**
+     * @brief 已统计的帧数
+     */
+    unsigned long getFrames() const { return frames; }
+
+    static const char* phaseName(Phase p);
+    static const char* counterName(Counter c);
+
+    /**
+     * @brief 输出统计表 (各阶段与计数的 min/avg/max/p99，以及最耗时的控件)
+     * 每行在栈上拼接后交给 write，不分配内存。
+     */
+    void dump(LineWriter write, void* user = nullptr) const;
+};
+
+} // namespace Hydrogen
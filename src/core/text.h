@@ -0,0 +1,37 @@
+#pragma once
+#include <string>
+
+namespace Hydrogen {
+
+/**
+ * @brief 对静态字符串的引用 (字符串常量、Flash 中的文本)
+ * 控件只保存指针而不复制文本，节省 RAM。字符串必须在控件的整个生命周期内有效。
+ *
+ * @code
+ *   list->addItem(StaticText("系统信息"));
+ * @endcode
+ */
+struct StaticText {
+    const char* str;
+    explicit StaticText(const char* s) : str(s) {}
+};
+
+/**
+ * @brief 控件持有的文本
+ * 由 std::string 或 const char* 构造时复制一份；由 StaticText 构造时只引用，不占用堆内存。
+ */
+class TextValue {
+    std::string owned;
+    const char* ref; ///< 引用的静态文本，nullptr 表示使用 owned
+
+public:
+    TextValue() : ref("") {}
+    TextValue(const std::string& s) : owned(s), ref(nullptr) {}
+    TextValue(const char* s) : owned(s ? s : ""), ref(nullptr) {}
+    TextValue(StaticText s) : ref(s.str ? s.str : "") {}
+
+    const char* c_str() const { return ref ? ref : owned.c_str(); }
+    bool empty() const { return c_str()[0] == '\0'; }
+};
+
+} // namespace Hydrogen
@@ -0,0 +1,64 @@
+#include "text_cache.h"
+#include <string.h>
+
+namespace Hydrogen {
+
+void TextWidthCache::clear() {
+    for (int i = 0; i < CAPACITY; ++i) entries[i].width = -1;
+    for (int i = 0; i < CAPACITY / WAYS; ++i) recent[i] = 0;
+}
+
+int TextWidthCache::measure(HAL* hal, const Font* nativeFont, const char* s) {
+    if (!s) return 0;
+    return measure(hal, nativeFont, s, strlen(s), true);
+}
+
+int TextWidthCache::measure(HAL* hal, const Font* nativeFont, const char* s, size_t length, bool terminated) {
+    if (length == 0) return 0;
+
+    // 字体变了，之前测量的宽度全部作废
+    const void* currentFont = nativeFont ? (const void*)nativeFont : hal->getFontId();
+    if (currentFont != font) {
+        clear();
+        font = currentFont;
+    }
+
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= (uint8_t)s[i];
+        hash *= 16777619u;
+    }
+
+    int set = (int)((hash ^ (hash >> 16)) & (CAPACITY / WAYS - 1));
+    Entry* ways = &entries[set * WAYS];
+    for (int i = 0; i < WAYS; ++i) {
+        if (ways[i].width >= 0 && ways[i].hash == hash && ways[i].length == (uint16_t)length) {
+            recent[set] = (uint8_t)i;
+            hits++;
+            return ways[i].width;
+        }
+    }
+
+    misses++;
+    int width;
+    if (nativeFont) {
+        width = nativeFont->measure(s, length);
+    } else {
+#if HYDROGEN_ENABLE_STATS
+        halMeasures++;
+#endif
+        width = terminated ? hal->getStrWidth(s) : hal->getStrWidthN(s, length);
+    }
+    if (width > 0x7FFF || length > 0xFFFF) return width; // 超出槽位的表示范围，不缓存
+    // 替换组内较久未使用的一项
+    int victim = (recent[set] + 1) % WAYS;
+    Entry& e = ways[victim];
+    e.hash = hash;
+    e.length = (uint16_t)length;
+    e.width = (int16_t)width;
+    recent[set] = (uint8_t)victim;
+    return width;
+}
+
+} // namespace Hydrogen
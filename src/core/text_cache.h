@@ -0,0 +1,86 @@
+#pragma once
+#include "../hal/hal.h"
+#include "font.h"
+#include "stats.h"
+#include <stdint.h>
+#include <stddef.h>
+
+namespace Hydrogen {
+
+/**
+ * @brief 文本宽度缓存
+ *
+ * HAL::getStrWidth() 在 U8g2 的中文字库下需要逐字解码 UTF-8 并在字库的
+ * Unicode 表中查找字形，列表每帧重复测量相同的文本时开销明显。
+ * 本缓存按 (内容哈希, 字节数) 映射到固定数量的槽位 (2 路组相联，组内替换较旧的一项)，
+ * 并记录测量时的字体 (原生 Font 或 HAL::getFontId())：字体变化后整个缓存失效。
+ *
+ * 命中只比较 32 位哈希与长度，不保存文本本身，因此不持有任何字符串内存。
+ */
+class TextWidthCache {
+public:
+    static const int CAPACITY = 32; ///< 槽位数 (2 的幂)
+    static const int WAYS = 2;      ///< 每组的槽位数
+
+private:
+    struct Entry {
+        uint32_t hash;
+        uint16_t length;
+        int16_t width;  ///< -1 表示空槽
+    };
+
+    Entry entries[CAPACITY];
+    uint8_t recent[CAPACITY / WAYS]; ///< 每组最近使用的槽位
+    const void* font;   ///< 缓存内容对应的字体
+    unsigned long hits;
+    unsigned long misses;
+#if HYDROGEN_ENABLE_STATS
+    unsigned long halMeasures; ///< 未命中时调用 HAL::getStrWidth 的次数 (不清零，帧统计按差值计)
+#endif
+
+    /**
+     * @param terminated 文本在 length 处以 '\0' 结尾，未命中时可直接交给 getStrWidth()
+     */
+    int measure(HAL* hal, const Font* font, const char* s, size_t length, bool terminated);
+
+public:
+    TextWidthCache() : font(nullptr), hits(0), misses(0) {
+#if HYDROGEN_ENABLE_STATS
+        halMeasures = 0;
+#endif
+        clear();
+    }
+
+    /**
+     * @brief 测量文本宽度，优先从缓存读取
+     * @param hal 未命中时用于测量的 HAL
+     * @param font 原生字体，为 nullptr 时使用 HAL 自身的字体
+     * @param s 文本 (UTF-8)
+     */
+    int measure(HAL* hal, const Font* font, const char* s);
+
+    /**
+     * @brief 测量文本前 length 字节的宽度 (文本无需以 '\0' 结尾)
+     */
+    int measure(HAL* hal, const Font* font, const char* s, size_t length) {
+        return measure(hal, font, s, length, false);
+    }
+
+    /**
+     * @brief 清空缓存 (不影响命中统计)
+     */
+    void clear();
+
+    unsigned long getHits() const { return hits; }
+    unsigned long getMisses() const { return misses; }
+#if HYDROGEN_ENABLE_STATS
+    unsigned long getHalMeasures() const { return halMeasures; }
+#endif
+
+    /**
+     * @brief 清零命中统计
+     */
+    void resetStats() { hits = misses = 0; }
+};
+
+} // namespace Hydrogen
@@ -0,0 +1,280 @@
+#include "tile_renderer.h"
+#include <algorithm>
+
+#if defined(ESP_PLATFORM)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#elif HYDROGEN_HOST_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace Hydrogen {
+
+#if defined(ESP_PLATFORM)
+
+/**
+ * @brief FreeRTOS 工作池：每个辅助任务固定在一个核心上，用信号量启动和汇合
+ */
+struct TileRenderer::Workers {
+    static const uint32_t STACK_SIZE = 3072;
+
+    struct Helper {
+        Workers* pool;
+        SemaphoreHandle_t go;
+    };
+
+    TileRenderer* owner;
+    std::vector<Helper> helpers;
+    SemaphoreHandle_t done;
+    volatile bool stopping;
+
+    static void task(void* arg) {
+        Helper* h = static_cast<Helper*>(arg);
+        for (;;) {
+            xSemaphoreTake(h->go, portMAX_DELAY);
+            if (h->pool->stopping) break;
+            h->pool->owner->work();
+            xSemaphoreGive(h->pool->done);
+        }
+        xSemaphoreGive(h->pool->done);
+        vTaskDelete(nullptr);
+    }
+
+    Workers(TileRenderer* owner, int count)
+        : owner(owner), helpers(count), done(xSemaphoreCreateCounting(count, 0)), stopping(false) {
+        for (int i = 0; i < count; ++i) {
+            helpers[i].pool = this;
+            helpers[i].go = xSemaphoreCreateBinary();
+            // 从下一个核心开始依次分配 (单核芯片上都在同一核心)
+            BaseType_t core = (xPortGetCoreID() + 1 + i) % portNUM_PROCESSORS;
+            xTaskCreatePinnedToCore(task, "hydrogen_tile", STACK_SIZE, &helpers[i], uxTaskPriorityGet(nullptr),
+                                    nullptr, core);
+        }
+    }
+
+    ~Workers() {
+        stopping = true;
+        for (size_t i = 0; i < helpers.size(); ++i) xSemaphoreGive(helpers[i].go);
+        for (size_t i = 0; i < helpers.size(); ++i) xSemaphoreTake(done, portMAX_DELAY);
+        for (size_t i = 0; i < helpers.size(); ++i) vSemaphoreDelete(helpers[i].go);
+        vSemaphoreDelete(done);
+    }
+
+    void run() {
+        for (size_t i = 0; i < helpers.size(); ++i) xSemaphoreGive(helpers[i].go);
+        owner->work();
+        for (size_t i = 0; i < helpers.size(); ++i) xSemaphoreTake(done, portMAX_DELAY);
+    }
+};
+
+#elif HYDROGEN_HOST_THREADS
+
+/**
+ * @brief std::thread 工作池：按帧号唤醒辅助线程，最后一个完成的线程通知调用线程
+ */
+struct TileRenderer::Workers {
+    TileRenderer* owner;
+    std::vector<std::thread> threads;
+    std::mutex lock;
+    std::condition_variable start;
+    std::condition_variable done;
+    unsigned long generation; ///< 已发布的帧号
+    int busy;                 ///< 本帧尚未完成的辅助线程数
+    bool stopping;
+
+    void loop() {
+        unsigned long seen = 0;
+        std::unique_lock<std::mutex> guard(lock);
+        for (;;) {
+            start.wait(guard, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            guard.unlock();
+            owner->work();
+            guard.lock();
+            if (--busy == 0) done.notify_one();
+        }
+    }
+
+    Workers(TileRenderer* owner, int count) : owner(owner), generation(0), busy(0), stopping(false) {
+        for (int i = 0; i < count; ++i) threads.emplace_back(&Workers::loop, this);
+    }
+
+    ~Workers() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        start.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    void run() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            generation++;
+            busy = (int)threads.size();
+        }
+        start.notify_all();
+        owner->work();
+        std::unique_lock<std::mutex> guard(lock);
+        done.wait(guard, [&] { return busy == 0; });
+    }
+};
+
+#else
+
+/**
+ * @brief 没有线程支持的平台：只有调用线程一个工作者
+ */
+struct TileRenderer::Workers {
+    TileRenderer* owner;
+    Workers(TileRenderer* owner, int) : owner(owner) {}
+    void run() { owner->work(); }
+};
+
+#endif
+
+TileRenderer::TileRenderer(FramebufferHAL* target, int workers)
+    : target(target), hasText(false), lastClip{0, 0, -1, -1}, clipWindow{0, 0, 0, 0}, nextBand(0),
+      workerCount(workers < 1 ? 1 : workers), workers(nullptr), parallelFrames(0), serialFrames(0) {
+    #if !defined(ESP_PLATFORM) && !HYDROGEN_HOST_THREADS
+    workerCount = 1;
+    #endif
+    // 条带按页对齐；屏幕较高时加大条带，保证条带数不超过位掩码的宽度
+    int height = target->getHeight();
+    int perBand = (height + MAX_BANDS - 1) / MAX_BANDS;
+    bandHeight = std::max(8, (perBand + 7) / 8 * 8);
+    bandCount = (height + bandHeight - 1) / bandHeight;
+    clipWindow = Rect{0, 0, target->getWidth(), height};
+    if (workerCount > 1) this->workers = new Workers(this, workerCount - 1);
+}
+
+TileRenderer::~TileRenderer() {
+    delete workers;
+}
+
+uint32_t TileRenderer::bandsOf(int y0, int y1) const {
+    int height = target->getHeight();
+    if (y1 < 0 || y0 >= height || y1 < y0) return 0;
+    int b0 = std::max(y0, 0) / bandHeight;
+    int b1 = std::min(y1, height - 1) / bandHeight;
+    uint32_t upTo = b1 >= 31 ? 0xFFFFFFFFu : (1u << (b1 + 1)) - 1;
+    return upTo & ~((1u << b0) - 1);
+}
+
+void TileRenderer::record(Op op, int x, int y, int w, int h, uint8_t color) {
+    if (w <= 0 || h <= 0 || x >= target->getWidth() || x + w <= 0) return;
+    uint32_t bands = bandsOf(y, y + h - 1);
+    if (!bands) return;
+    Command c = {op, color, (int16_t)x, (int16_t)y, (int16_t)w, (int16_t)h, bands, nullptr, 0};
+    commands.push_back(c);
+}
+
+void TileRenderer::drawXBM(int x, int y, int w, int h, const uint8_t* bitmap) {
+    size_t before = commands.size();
+    record(Op::Bitmap, x, y, w, h, 1);
+    if (commands.size() > before) commands.back().bitmap = bitmap;
+}
+
+void TileRenderer::drawStrN(int x, int y, const char* s, size_t n) {
+    // 文本由 HAL 按裁剪窗口绘制，裁剪窗口变化时一并记录
+    if (clipWindow.x != lastClip.x || clipWindow.y != lastClip.y || clipWindow.w != lastClip.w ||
+        clipWindow.h != lastClip.h) {
+        Command c = {Op::Clip, 0, (int16_t)clipWindow.x, (int16_t)clipWindow.y, (int16_t)clipWindow.w,
+                     (int16_t)clipWindow.h, 0, nullptr, 0};
+        commands.push_back(c);
+        lastClip = clipWindow;
+    }
+    if (n > 0x7FFF) n = 0x7FFF;
+    Command c = {Op::Text, 1, (int16_t)x, (int16_t)y, (int16_t)n, 0, 0, nullptr, (uint32_t)texts.size()};
+    commands.push_back(c);
+    texts.insert(texts.end(), s, s + n);
+    hasText = true;
+}
+
+void TileRenderer::replay(const Command& c, int y0, int y1) {
+    int top = std::max<int>(c.y, y0);
+    int bottom = std::min<int>(c.y + c.h, y1);
+    switch (c.op) {
+    case Op::Pixel:
+        if (bottom > top) target->drawPixel(c.x, c.y, c.color);
+        break;
+    case Op::HLine:
+        if (bottom > top) target->drawHLine(c.x, c.y, c.w, c.color);
+        break;
+    case Op::VLine:
+        if (bottom > top) target->drawVLine(c.x, top, bottom - top, c.color);
+        break;
+    case Op::Fill:
+        if (bottom > top) target->fillRect(c.x, top, c.w, bottom - top, c.color);
+        break;
+    case Op::Bitmap:
+        if (bottom > top) target->drawXBM(c.x, top, c.w, bottom - top, c.bitmap + (top - c.y) * ((c.w + 7) / 8));
+        break;
+    case Op::Clip:
+        target->setClipWindow(c.x, c.y, c.w, c.h);
+        break;
+    case Op::Text:
+        target->drawStrN(c.x, c.y, &texts[c.text], (size_t)c.w);
+        break;
+    }
+}
+
+void TileRenderer::work() {
+    int height = target->getHeight();
+    for (int band = nextBand.fetch_add(1); band < bandCount; band = nextBand.fetch_add(1)) {
+        uint32_t bit = 1u << band;
+        int y0 = band * bandHeight;
+        int y1 = std::min(y0 + bandHeight, height);
+        for (const Command& c : commands) {
+            if (c.bands & bit) replay(c, y0, y1);
+        }
+    }
+}
+
+void TileRenderer::rasterize() {
+    if (commands.empty()) return;
+
+    if (hasText || workerCount == 1) {
+        // 按记录顺序整屏执行
+        for (const Command& c : commands) replay(c, 0, target->getHeight());
+        serialFrames++;
+    } else {
+        nextBand.store(0);
+        workers->run();
+        parallelFrames++;
+    }
+
+    commands.clear();
+    texts.clear();
+    hasText = false;
+    lastClip = Rect{0, 0, -1, -1};
+}
+
+void TileRenderer::init() {
+    commands.clear();
+    texts.clear();
+    hasText = false;
+    target->init();
+}
+
+void TileRenderer::update() {
+    rasterize();
+    target->update();
+}
+
+void TileRenderer::updateRegion(int x, int y, int w, int h) {
+    rasterize();
+    target->updateRegion(x, y, w, h);
+}
+
+bool TileRenderer::beginFlush(int x, int y, int w, int h) {
+    rasterize();
+    return target->beginFlush(x, y, w, h);
+}
+
+} // namespace Hydrogen
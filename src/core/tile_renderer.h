@@ -0,0 +1,147 @@
+#pragma once
+#include "../hal/hal_framebuffer.h"
+#include "graphics.h"
+#include <atomic>
+#include <vector>
+
+/**
+ * @brief 主机端是否使用 std::thread (TileRenderer 的工作池、HydrogenUI.h 自动包含 ThreadedFramebufferHAL)
+ *
+ * 默认关闭：裸机工具链 (arm-none-eabi、STM32Cube、Zephyr 等) 没有 std::thread，此时 TileRenderer
+ * 只在调用线程上顺序光栅化。在 PC 上模拟或测量时以 -DHYDROGEN_HOST_THREADS=1 -pthread 编译。
+ * ESP32 (ESP_PLATFORM) 不受影响，始终使用 FreeRTOS 任务。
+ */
+#ifndef HYDROGEN_HOST_THREADS
+#define HYDROGEN_HOST_THREADS 0
+#endif
+
+namespace Hydrogen {
+
+/**
+ * @brief 分带并行光栅化的 HAL (包装一个 FramebufferHAL)
+ *
+ * 绘图调用不立即执行，而是记录为命令并按所触及的水平条带 (band) 分箱；刷新前
+ * (update/updateRegion/beginFlush) 由一个小型工作池并行光栅化：每个工作者领取一个条带，
+ * 只执行与它相交的命令并裁剪到条带内。条带按页 (8 行) 对齐，帧缓冲中各条带的字节互不重叠，
+ * 写像素无需加锁。同一条带内的命令保持原有顺序，结果与直接绘制逐像素一致。
+ *
+ * 工作者数包括调用 App.update() 的线程本身：1 表示不创建额外线程。
+ * ESP32 (ESP_PLATFORM) 上用 FreeRTOS 任务并分配到各个核心，定义了 HYDROGEN_HOST_THREADS 的主机端用 std::thread，
+ * 其他平台只有调用线程一个工作者。
+ *
+ * HAL 自带字体绘制的文本 (drawStr) 依赖 HAL 的内部状态，含有这类文本的帧在调用线程上
+ * 顺序光栅化；使用原生字体 (Graphics::setFont) 时字形经 drawXBM 绘制，可以并行。
+ * drawXBM 传入的位图需保持有效到本帧刷新 (字库与常量位图均满足)。
+ *
+ * @code
+ *   static FramebufferHAL fb(128, 64);
+ *   static TileRenderer tiles(&fb, 2);
+ *   App.begin(&tiles);
+ * @endcode
+ */
+class TileRenderer : public HAL {
+public:
+    static const int MAX_BANDS = 32; ///< 条带数上限 (屏幕较高时加大条带高度)
+
+private:
+    enum class Op : uint8_t { Pixel, HLine, VLine, Fill, Bitmap, Clip, Text };
+
+    struct Command {
+        Op op;
+        uint8_t color;
+        int16_t x, y, w, h;
+        uint32_t bands;          ///< 触及的条带 (位掩码)
+        const uint8_t* bitmap;   ///< Bitmap: 位图
+        uint32_t text;           ///< Text: 文本在 texts 中的偏移 (长度存于 w)
+    };
+
+    struct Workers;
+
+    FramebufferHAL* target;
+    std::vector<Command> commands;
+    std::vector<char> texts;     ///< Text 命令的文本 (调用方的缓冲区可能是临时的)
+    bool hasText;                ///< 本帧含有 HAL 文本，需顺序光栅化
+    Rect lastClip;               ///< 最近一次记录的裁剪窗口
+    Rect clipWindow;             ///< 当前裁剪窗口
+    int bandHeight;
+    int bandCount;
+    std::atomic<int> nextBand;   ///< 下一个待领取的条带
+    int workerCount;
+    Workers* workers;
+    unsigned long parallelFrames;
+    unsigned long serialFrames;
+
+    TileRenderer(const TileRenderer&);
+    TileRenderer& operator=(const TileRenderer&);
+
+    /**
+     * @brief 行区间 [y0, y1] 触及的条带掩码，完全在屏幕外时为 0
+     */
+    uint32_t bandsOf(int y0, int y1) const;
+
+    void record(Op op, int x, int y, int w, int h, uint8_t color);
+
+    /**
+     * @brief 执行一条命令中落在行区间 [y0, y1) 内的部分
+     */
+    void replay(const Command& c, int y0, int y1);
+
+    /**
+     * @brief 工作者的主体：不断领取条带并光栅化，直到条带领完
+     */
+    void work();
+
+public:
+    /**
+     * @param target 实际的帧缓冲 (需在渲染器的整个生命周期内有效)
+     * @param workers 工作者数 (含调用线程)，不小于 1
+     */
+    TileRenderer(FramebufferHAL* target, int workers);
+    ~TileRenderer() override;
+
+    /**
+     * @brief 光栅化已记录的命令 (刷新前自动调用)
+     */
+    void rasterize();
+
+    int getWorkerCount() const { return workerCount; }
+    int getBandHeight() const { return bandHeight; }
+    int getBandCount() const { return bandCount; }
+
+    /**
+     * @brief 并行光栅化的帧数
+     */
+    unsigned long getParallelFrames() const { return parallelFrames; }
+
+    /**
+     * @brief 因含有 HAL 文本而顺序光栅化的帧数
+     */
+    unsigned long getSerialFrames() const { return serialFrames; }
+
+    void init() override;
+    void clear() override { record(Op::Fill, 0, 0, target->getWidth(), target->getHeight(), 0); }
+    void update() override;
+    void updateRegion(int x, int y, int w, int h) override;
+    bool beginFlush(int x, int y, int w, int h) override;
+    bool isFlushDone() override { return target->isFlushDone(); }
+    void waitFlush() override { target->waitFlush(); }
+
+    void drawPixel(int x, int y, uint8_t color) override { record(Op::Pixel, x, y, 1, 1, color); }
+    void drawHLine(int x, int y, int w, uint8_t color) override { record(Op::HLine, x, y, w, 1, color); }
+    void drawVLine(int x, int y, int h, uint8_t color) override { record(Op::VLine, x, y, 1, h, color); }
+    void fillRect(int x, int y, int w, int h, uint8_t color) override { record(Op::Fill, x, y, w, h, color); }
+    void drawXBM(int x, int y, int w, int h, const uint8_t* bitmap) override;
+    void setClipWindow(int x, int y, int w, int h) override { clipWindow = Rect{x, y, w, h}; }
+    void drawStr(int x, int y, const char* s) override { drawStrN(x, y, s, strlen(s)); }
+    void drawStrN(int x, int y, const char* s, size_t n) override;
+
+    int getWidth() const override { return target->getWidth(); }
+    int getHeight() const override { return target->getHeight(); }
+    int getStrWidth(const char* s) override { return target->getStrWidth(s); }
+    int getStrWidthN(const char* s, size_t n) override { return target->getStrWidthN(s, n); }
+    const void* getFontId() override { return target->getFontId(); }
+    unsigned long getMillis() override { return target->getMillis(); }
+    unsigned long getMicros() override { return target->getMicros(); }
+};
+
+} // namespace Hydrogen
@@ -0,0 +1,12 @@
+#pragma once
+
+/**
+ * @brief 逻辑更新的固定步长 (毫秒)
+ *
+ * Application 按此步长推进动画与控件逻辑，与实际渲染帧率无关：
+ * 渲染变慢时一次 update() 会补跑多个步长，渲染很快时则可能一个步长都不跑。
+ * 可在编译时覆盖，如 -DHYDROGEN_TICK_MS=10。
+ */
+#ifndef HYDROGEN_TICK_MS
+#define HYDROGEN_TICK_MS 16
+#endif
@@ -0,0 +1,138 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+namespace Hydrogen {
+
+/**
+ * @brief 帧差分：只推送与上次送出的画面不同的 Tile
+ *
+ * 保存最近一次送出的 1bpp 页布局缓冲区 (SSD1306 页模式：每页 8 行，每字节一列) 的副本，
+ * 刷新时按 8x8 的 Tile 与新画面比较，每个 Tile 在一页内正好是 8 个连续字节，按一个 64 位字比较；
+ * 整页相同时由 memcmp (主机 libc 的 SIMD 实现、ESP32 的字比较) 一次跳过。
+ * 同一页内变化的 Tile 合并为连续的段 (间隔不超过 MERGE_GAP 个 Tile 的段也合并，
+ * 省去多发一次寻址命令)，逐段交给区域刷新接口。
+ *
+ * 适合无法精确上报脏区域的控件 (整屏失效但每帧只变化几页) 以及 I2C 这类慢总线。
+ * 副本首次被完整送出之前，刷新按原样推送整个区域。
+ */
+class FrameDiffer {
+public:
+    static const int TILE = 8;      ///< Tile 宽度 (列)，一页内一个 Tile 为 8 字节
+    static const int MERGE_GAP = 1; ///< 间隔不超过这么多个未变化 Tile 的段合并发送
+
+private:
+    int width;       ///< 每页字节数 (列数)
+    int pages;
+    uint8_t* shadow; ///< 最近一次送出的画面
+    bool valid;      ///< shadow 与屏幕一致
+
+    FrameDiffer(const FrameDiffer&);
+    FrameDiffer& operator=(const FrameDiffer&);
+
+    bool tileChanged(const uint8_t* a, const uint8_t* b, int n) const {
+        if (n == TILE) {
+            uint64_t u, v;
+            memcpy(&u, a, TILE);
+            memcpy(&v, b, TILE);
+            return u != v;
+        }
+        return memcmp(a, b, n) != 0; // 宽度不是 8 的倍数时的最后一个 Tile
+    }
+
+public:
+    FrameDiffer(int width, int pages)
+        : width(width), pages(pages), shadow(new uint8_t[width * pages]), valid(false) {}
+
+    ~FrameDiffer() { delete[] shadow; }
+
+    /**
+     * @brief 屏幕内容已不可知 (如重新初始化了屏幕)，下一次整屏刷新完整推送
+     */
+    void invalidate() { valid = false; }
+
+    bool isValid() const { return valid; }
+
+    /**
+     * @brief 比较区域内的 Tile，逐段推送变化的部分并更新副本
+     * @param buffer 新画面
+     * @param x 起始列 (向下对齐到 Tile)
+     * @param firstPage 起始页
+     * @param w 列数 (向上对齐到 Tile)
+     * @param pageCount 页数
+     * @param send 推送一段：send(x, page, w, pages)
+     * @return 推送的字节数
+     */
+    template <class Send>
+    size_t flush(const uint8_t* buffer, int x, int firstPage, int w, int pageCount, Send send) {
+        int t0 = x / TILE;
+        int t1 = (x + w + TILE - 1) / TILE;
+        int tileCount = (width + TILE - 1) / TILE;
+        if (t1 > tileCount) t1 = tileCount;
+
+        if (!valid) {
+            // 屏幕内容未知：按原样推送，整屏推送后副本生效
+            send(x, firstPage, w, pageCount);
+            for (int page = firstPage; page < firstPage + pageCount; ++page) {
+                memcpy(shadow + page * width + x, buffer + page * width + x, w);
+            }
+            valid = x == 0 && firstPage == 0 && w == width && pageCount == pages;
+            return (size_t)w * pageCount;
+        }
+
+        size_t sent = 0;
+        int x0 = t0 * TILE;
+        int x1 = t1 * TILE < width ? t1 * TILE : width;
+        for (int page = firstPage; page < firstPage + pageCount; ++page) {
+            const uint8_t* src = buffer + page * width;
+            uint8_t* dst = shadow + page * width;
+            if (memcmp(src + x0, dst + x0, x1 - x0) == 0) continue;
+
+            int runStart = -1;
+            int runEnd = -1; // 最后一个变化的 Tile + 1
+            for (int t = t0; t <= t1; ++t) {
+                bool changed = false;
+                if (t < t1) {
+                    int n = (t + 1) * TILE <= width ? TILE : width - t * TILE;
+                    changed = tileChanged(src + t * TILE, dst + t * TILE, n);
+                }
+                if (changed) {
+                    if (runStart < 0) runStart = t;
+                    runEnd = t + 1;
+                } else if (runStart >= 0 && (t == t1 || t - runEnd >= MERGE_GAP)) {
+                    int rx = runStart * TILE;
+                    int rw = (runEnd * TILE < width ? runEnd * TILE : width) - rx;
+                    send(rx, page, rw, 1);
+                    memcpy(dst + rx, src + rx, rw);
+                    sent += rw;
+                    runStart = -1;
+                }
+            }
+        }
+        return sent;
+    }
+
+    /**
+     * @brief 求区域内变化的 Tile 的包围盒并更新副本 (用于一次只能发起一段传输的异步刷新)
+     * 副本尚未生效时返回整个区域。
+     * @return 没有任何变化时返回 false
+     */
+    bool changedBounds(const uint8_t* buffer, int& x, int& firstPage, int& w, int& pageCount) {
+        int bx0 = width, bx1 = 0, bp0 = pages, bp1 = -1;
+        size_t sent = flush(buffer, x, firstPage, w, pageCount, [&](int rx, int page, int rw, int rpages) {
+            if (rx < bx0) bx0 = rx;
+            if (rx + rw > bx1) bx1 = rx + rw;
+            if (page < bp0) bp0 = page;
+            if (page + rpages - 1 > bp1) bp1 = page + rpages - 1;
+        });
+        if (sent == 0) return false;
+        x = bx0;
+        w = bx1 - bx0;
+        firstPage = bp0;
+        pageCount = bp1 - bp0 + 1;
+        return true;
+    }
+};
+
+} // namespace Hydrogen
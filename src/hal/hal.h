@@ -1,6 +1,7 @@
 #pragma once
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 #include <string>
 
 namespace Hydrogen {
@@ -31,6 +32,45 @@ public:
      */
     virtual void update() = 0;
 
+    /**
+     * @brief 仅刷新屏幕的一部分
+     * 用于局部重绘：只推送被修改过的区域，减少总线传输量。
+     * 默认实现退化为整屏刷新。驱动可按自身的最小传输单元 (页/Tile) 向外对齐。
+     * @param x 区域左上角 X
+     * @param y 区域左上角 Y
+     * @param w 区域宽度
+     * @param h 区域高度
+     */
+    virtual void updateRegion(int x, int y, int w, int h) {
+        (void)x; (void)y; (void)w; (void)h;
+        update();
+    }
+
+    /**
+     * @brief 开始异步刷新一个区域 (DMA 或传输任务)
+     * 返回 true 表示传输已在后台开始：HAL 把当前缓冲区交给传输方，之后的绘制进入另一块
+     * 内容相同的缓冲区，渲染下一帧与传输本帧同时进行。
+     * 默认返回 false，表示不支持异步刷新，Application 改用 update()/updateRegion()。
+     * 区域需覆盖上次 beginFlush() 以来绘制过的所有像素；只在上一次传输完成 (isFlushDone) 后调用。
+     */
+    virtual bool beginFlush(int x, int y, int w, int h) {
+        (void)x; (void)y; (void)w; (void)h;
+        return false;
+    }
+
+    /**
+     * @brief 上一次 beginFlush() 开始的传输是否已经完成
+     */
+    virtual bool isFlushDone() { return true; }
+
+    /**
+     * @brief 等待进行中的传输完成
+     * 默认轮询 isFlushDone()，驱动可覆盖为阻塞等待 (信号量、条件变量)。
+     */
+    virtual void waitFlush() {
+        while (!isFlushDone()) {}
+    }
+
     /**
      * @brief 绘制一个像素点
      * @param x X 坐标
@@ -39,6 +79,65 @@ public:
      */
     virtual void drawPixel(int x, int y, uint8_t color) = 0;
 
+    /**
+     * @brief 绘制水平线段 (批量接口)
+     * 默认实现逐点调用 drawPixel，底层驱动可覆盖为原生的快速实现。
+     * @param x 起点 X 坐标
+     * @param y Y 坐标
+     * @param w 长度 (像素)
+     * @param color 颜色值 (1=亮, 0=灭)
+     */
+    virtual void drawHLine(int x, int y, int w, uint8_t color) {
+        for (int i = 0; i < w; ++i) drawPixel(x + i, y, color);
+    }
+
+    /**
+     * @brief 绘制垂直线段 (批量接口)
+     * @param x X 坐标
+     * @param y 起点 Y 坐标
+     * @param h 长度 (像素)
+     * @param color 颜色值 (1=亮, 0=灭)
+     */
+    virtual void drawVLine(int x, int y, int h, uint8_t color) {
+        for (int j = 0; j < h; ++j) drawPixel(x, y + j, color);
+    }
+
+    /**
+     * @brief 填充矩形区域 (批量接口)
+     * 默认实现按行调用 drawHLine。
+     */
+    virtual void fillRect(int x, int y, int w, int h, uint8_t color) {
+        for (int j = 0; j < h; ++j) drawHLine(x, y + j, w, color);
+    }
+
+    /**
+     * @brief 位图块传输 (XBM 格式)
+     * 每行 (w + 7) / 8 字节，字节内低位在左。仅绘制为 1 的位（透明背景）。
+     * @param bitmap 位图数据，共 h 行
+     */
+    virtual void drawXBM(int x, int y, int w, int h, const uint8_t* bitmap) {
+        int rowBytes = (w + 7) / 8;
+        for (int j = 0; j < h; ++j) {
+            const uint8_t* row = bitmap + j * rowBytes;
+            for (int i = 0; i < w; ++i) {
+                if (row[i >> 3] & (1 << (i & 7))) drawPixel(x + i, y + j, 1);
+            }
+        }
+    }
+
+    /**
+     * @brief 设置裁剪窗口
+     * Graphics 自身的图元已经完成裁剪，此接口主要供 HAL 自己绘制的内容 (如 drawStr) 使用。
+     * 默认实现为空操作。
+     * @param x 窗口左上角 X
+     * @param y 窗口左上角 Y
+     * @param w 窗口宽度
+     * @param h 窗口高度
+     */
+    virtual void setClipWindow(int x, int y, int w, int h) {
+        (void)x; (void)y; (void)w; (void)h;
+    }
+
     /**
      * @brief 获取屏幕宽度
      * @return 宽度像素值
@@ -67,12 +166,80 @@ public:
      */
     virtual int getStrWidth(const char* s) = 0;
 
+    /**
+     * @brief 绘制字符串的前 n 个字节 (文本无需以 '\0' 结尾)
+     * 默认实现把文本按 UTF-8 字符边界分段复制到栈上再调用 drawStr()，
+     * 每段之后按 getStrWidth() 前移，不分配堆内存。驱动可覆盖为按长度直接绘制的实现。
+     * @param n 字节数
+     */
+    virtual void drawStrN(int x, int y, const char* s, size_t n) {
+        char buf[TEXT_CHUNK + 1];
+        while (n > 0) {
+            size_t len = copyTextChunk(buf, s, n);
+            drawStr(x, y, buf);
+            s += len;
+            n -= len;
+            if (n > 0) x += getStrWidth(buf);
+        }
+    }
+
+    /**
+     * @brief 获取字符串前 n 个字节的显示宽度
+     * 默认实现与 drawStrN() 一样分段调用 getStrWidth()。
+     */
+    virtual int getStrWidthN(const char* s, size_t n) {
+        char buf[TEXT_CHUNK + 1];
+        int w = 0;
+        while (n > 0) {
+            size_t len = copyTextChunk(buf, s, n);
+            w += getStrWidth(buf);
+            s += len;
+            n -= len;
+        }
+        return w;
+    }
+
+    /**
+     * @brief 获取当前字体的标识
+     * 用于文本宽度缓存 (TextWidthCache)：标识变化时缓存的宽度全部失效。
+     * 默认返回 nullptr，表示字体不会改变。
+     * @return 能唯一区分字体的指针 (如字库数据地址)
+     */
+    virtual const void* getFontId() { return nullptr; }
+
     /**
      * @brief 获取系统运行时间
      * 用于动画和帧率计算
      * @return 毫秒数
      */
     virtual unsigned long getMillis() = 0;
+
+    /**
+     * @brief 获取高精度系统时间
+     * 用于测量帧内各阶段的耗时 (参见 FrameGovernor)。
+     * 默认实现由 getMillis() 换算，精度只有 1ms。
+     * @return 微秒数 (允许回绕)
+     */
+    virtual unsigned long getMicros() { return getMillis() * 1000UL; }
+
+protected:
+    enum { TEXT_CHUNK = 48 }; ///< drawStrN/getStrWidthN 的分段长度 (字节)
+
+    /**
+     * @brief 复制不超过 TEXT_CHUNK 字节的文本并补 '\0'，不在多字节字符中间截断
+     * @return 复制的字节数
+     */
+    static size_t copyTextChunk(char* buf, const char* s, size_t n) {
+        size_t len = n < (size_t)TEXT_CHUNK ? n : (size_t)TEXT_CHUNK;
+        if (len < n) {
+            size_t cut = len;
+            while (cut > 0 && ((uint8_t)s[cut] & 0xC0) == 0x80) --cut; // 退回到字符首字节
+            if (cut > 0) len = cut;
+        }
+        memcpy(buf, s, len);
+        buf[len] = '\0';
+        return len;
+    }
 };
 
 } // namespace Hydrogen
@@ -0,0 +1,394 @@
+#pragma once
+#include "hal.h"
+#include "frame_diff.h"
+#include <string.h>
+#include <atomic>
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+namespace Hydrogen {
+
+/**
+ * @brief 内存帧缓冲 HAL
+ *
+ * 持有一块 1bpp 的紧凑帧缓冲，布局与 SSD1306 的页模式一致：
+ * 每 8 行组成一页，每个字节代表同一列的 8 个纵向像素 (低位在上)。
+ * 缓冲区地址 = page * width + x。
+ *
+ * 适用场景：
+ * - MCU 上自行处理总线传输（SPI/I2C/DMA）的快速路径
+ * - Linux 主机上的无头渲染目标（测试、基准）
+ *
+ * 填充类操作按页处理：整页直接 memset，部分页按 32 位字批量做或/与运算。
+ * 屏幕推送通过 setFlushCallback() 交给任意传输层。
+ *
+ * 开启双缓冲 (setDoubleBuffered) 后支持异步刷新 (beginFlush)：两块缓冲区交换，
+ * 传输方读取前台缓冲区 (getFrontBuffer)，下一帧画在后台缓冲区。交换时把送出的区域复制到
+ * 后台缓冲区，局部重绘照常只需重画变化的部分 (因此 beginFlush 的区域需覆盖上次交换以来
+ * 绘制过的所有像素)。默认的传输在 beginFlush() 中同步调用刷新回调；
+ * DMA 驱动或传输任务覆盖 startTransfer()，传输完成后调用 finishFlush()。
+ *
+ * 开启帧差分 (setDiffing) 后，刷新前与上次送出的画面逐 Tile 比较，只推送变化的部分
+ * (见 FrameDiffer)。getBytesSent() 统计实际推送的字节数。
+ */
+class FramebufferHAL : public HAL {
+public:
+    /**
+     * @brief 刷新回调
+     * @param fb 帧缓冲实例 (通过 getBuffer() 访问原始数据)
+     * @param x 起始列
+     * @param page 起始页
+     * @param w 列数
+     * @param pages 页数
+     * @param user 用户数据
+     */
+    typedef void (*FlushCallback)(const FramebufferHAL& fb, int x, int page, int w, int pages, void* user);
+
+private:
+    int width;
+    int height;
+    int pages;
+    uint8_t* buffer;      ///< 绘制缓冲区
+    uint8_t* frontBuffer; ///< 双缓冲时正在 (或最近一次) 传输的缓冲区，nullptr 表示单缓冲
+    std::atomic<bool> flushing;
+    FlushCallback flushCallback;
+    void* flushUser;
+    FrameDiffer* differ;  ///< 帧差分，nullptr 表示不比较
+    std::atomic<unsigned long> bytesSent;
+
+    FramebufferHAL(const FramebufferHAL&) = delete;
+    FramebufferHAL& operator=(const FramebufferHAL&) = delete;
+
+    /**
+     * @brief 对一段连续字节应用掩码
+     * color 非 0 时置位 (或运算)，为 0 时清零 (与运算)。
+     */
+    static void applyMask(uint8_t* p, int n, uint8_t mask, uint8_t color) {
+        if (mask == 0xFF) {
+            memset(p, color ? 0xFF : 0x00, n);
+            return;
+        }
+        uint32_t mask32 = mask * 0x01010101u;
+        if (color) {
+            for (; n >= 4; n -= 4, p += 4) {
+                uint32_t v;
+                memcpy(&v, p, 4);
+                v |= mask32;
+                memcpy(p, &v, 4);
+            }
+            while (n-- > 0) *p++ |= mask;
+        } else {
+            mask32 = ~mask32;
+            for (; n >= 4; n -= 4, p += 4) {
+                uint32_t v;
+                memcpy(&v, p, 4);
+                v &= mask32;
+                memcpy(p, &v, 4);
+            }
+            while (n-- > 0) *p++ &= (uint8_t)~mask;
+        }
+    }
+
+protected:
+    /**
+     * @brief 把区域裁剪到屏幕内并按页对齐
+     * @return 区域为空时返回 false
+     */
+    bool clipToPages(int& x, int& w, int y, int h, int& firstPage, int& pageCount) const {
+        if (x < 0) { w += x; x = 0; }
+        if (y < 0) { h += y; y = 0; }
+        if (x + w > width) w = width - x;
+        if (y + h > height) h = height - y;
+        if (w <= 0 || h <= 0) return false;
+        firstPage = y >> 3;
+        pageCount = ((y + h - 1) >> 3) - firstPage + 1;
+        return true;
+    }
+
+    /**
+     * @brief 调用刷新回调推送一块区域
+     */
+    void transfer(int x, int page, int w, int pageCount) {
+        bytesSent.fetch_add((unsigned long)w * pageCount, std::memory_order_relaxed);
+        if (flushCallback) flushCallback(*this, x, page, w, pageCount, flushUser);
+    }
+
+    /**
+     * @brief 同步推送一块区域 (update/updateRegion 经由此处，开启帧差分时逐段调用)
+     * 默认直接调用刷新回调；模拟总线耗时等场合可以覆盖。
+     */
+    virtual void syncTransfer(int x, int page, int w, int pageCount) {
+        transfer(x, page, w, pageCount);
+    }
+
+    /**
+     * @brief 推送页对齐的区域：开启帧差分时只推送变化的段
+     */
+    void flushPages(int x, int page, int w, int pageCount) {
+        if (!differ) {
+            syncTransfer(x, page, w, pageCount);
+            return;
+        }
+        differ->flush(buffer, x, page, w, pageCount,
+                      [this](int rx, int rpage, int rw, int rpages) { syncTransfer(rx, rpage, rw, rpages); });
+    }
+
+    /**
+     * @brief 开始传输前台缓冲区的一块区域 (beginFlush 交换缓冲区后调用)
+     * 默认同步调用刷新回调并立即完成。异步实现在传输结束时调用 finishFlush()。
+     */
+    virtual void startTransfer(int x, int page, int w, int pageCount) {
+        transfer(x, page, w, pageCount);
+        finishFlush();
+    }
+
+public:
+    /**
+     * @brief 构造函数
+     * @param width 屏幕宽度 (像素)
+     * @param height 屏幕高度 (像素)，不是 8 的倍数时最后一页只使用部分位
+     */
+    FramebufferHAL(int width, int height)
+        : width(width), height(height), pages((height + 7) / 8),
+          buffer(new uint8_t[width * ((height + 7) / 8)]), frontBuffer(nullptr), flushing(false),
+          flushCallback(nullptr), flushUser(nullptr), differ(nullptr), bytesSent(0) {
+        memset(buffer, 0, getBufferSize());
+    }
+
+    ~FramebufferHAL() override {
+        delete[] buffer;
+        delete[] frontBuffer;
+        delete differ;
+    }
+
+    /**
+     * @brief 开启或关闭帧差分 (多占用一块缓冲区大小的副本)
+     * 开启后的第一次整屏刷新完整推送，之后只推送变化的 Tile。需在没有进行中的传输时调用。
+     */
+    void setDiffing(bool on) {
+        if (on == (differ != nullptr)) return;
+        delete differ;
+        differ = on ? new FrameDiffer(width, pages) : nullptr;
+    }
+
+    bool isDiffing() const { return differ != nullptr; }
+
+    /**
+     * @brief 累计推送的字节数 (所有经过刷新回调的区域)，两次读数之差除以帧数即每帧字节数
+     */
+    unsigned long getBytesSent() const { return bytesSent.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 开启或关闭双缓冲 (多占用一块缓冲区的内存)
+     * 需在没有进行中的传输时调用。
+     */
+    void setDoubleBuffered(bool on) {
+        if (on == (frontBuffer != nullptr)) return;
+        if (on) {
+            frontBuffer = new uint8_t[getBufferSize()];
+            memcpy(frontBuffer, buffer, getBufferSize());
+        } else {
+            delete[] frontBuffer;
+            frontBuffer = nullptr;
+        }
+    }
+
+    bool isDoubleBuffered() const { return frontBuffer != nullptr; }
+
+    /**
+     * @brief 正在传输的缓冲区 (异步传输应从这里读取；单缓冲时即 getBuffer())
+     */
+    const uint8_t* getFrontBuffer() const { return frontBuffer ? frontBuffer : buffer; }
+
+    /**
+     * @brief 通知传输已完成 (可在 DMA 完成中断或传输任务中调用)
+     */
+    void finishFlush() { flushing.store(false, std::memory_order_release); }
+
+    /**
+     * @brief 设置刷新回调
+     * update() 时以整屏区域、updateRegion() 时以对齐到页的局部区域调用此回调，
+     * 由回调负责把数据推送到屏幕。
+     */
+    void setFlushCallback(FlushCallback cb, void* user = nullptr) {
+        flushCallback = cb;
+        flushUser = user;
+    }
+
+    /**
+     * @brief 获取原始缓冲区
+     */
+    uint8_t* getBuffer() { return buffer; }
+    const uint8_t* getBuffer() const { return buffer; }
+
+    /**
+     * @brief 缓冲区字节数 (width * pages)
+     */
+    size_t getBufferSize() const { return (size_t)width * pages; }
+
+    /**
+     * @brief 页数 (每页 8 行)
+     */
+    int getPageCount() const { return pages; }
+
+    /**
+     * @brief 读取像素
+     * @return 1=亮, 0=灭 (越界返回 0)
+     */
+    uint8_t getPixel(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) return 0;
+        return (buffer[(y >> 3) * width + x] >> (y & 7)) & 1;
+    }
+
+    void init() override {
+        clear();
+        if (differ) differ->invalidate();
+    }
+
+    void clear() override {
+        memset(buffer, 0, getBufferSize());
+    }
+
+    void update() override {
+        flushPages(0, 0, width, pages);
+    }
+
+    void updateRegion(int x, int y, int w, int h) override {
+        int firstPage, pageCount;
+        if (clipToPages(x, w, y, h, firstPage, pageCount)) flushPages(x, firstPage, w, pageCount);
+    }
+
+    bool beginFlush(int x, int y, int w, int h) override {
+        if (!frontBuffer) return false;
+        int firstPage, pageCount;
+        if (!clipToPages(x, w, y, h, firstPage, pageCount)) return true;
+
+        // 刚画好的一帧成为前台缓冲区。后台缓冲区停留在上一次交换时的内容，与它只在本次
+        // 送出的区域内不同，复制这部分后下一帧即可在此基础上局部重绘
+        uint8_t* drawn = buffer;
+        buffer = frontBuffer;
+        frontBuffer = drawn;
+        for (int page = firstPage; page < firstPage + pageCount; ++page) {
+            memcpy(buffer + page * width + x, frontBuffer + page * width + x, w);
+        }
+
+        // 异步传输一次只有一段：开启帧差分时缩小到变化的 Tile 的包围盒，完全没变则不传输
+        if (differ && !differ->changedBounds(frontBuffer, x, firstPage, w, pageCount)) return true;
+        flushing.store(true, std::memory_order_relaxed);
+        startTransfer(x, firstPage, w, pageCount);
+        return true;
+    }
+
+    bool isFlushDone() override { return !flushing.load(std::memory_order_acquire); }
+
+    void drawPixel(int x, int y, uint8_t color) override {
+        if (x < 0 || y < 0 || x >= width || y >= height) return;
+        uint8_t bit = 1 << (y & 7);
+        uint8_t* p = &buffer[(y >> 3) * width + x];
+        if (color) *p |= bit; else *p &= (uint8_t)~bit;
+    }
+
+    void drawHLine(int x, int y, int w, uint8_t color) override {
+        if (y < 0 || y >= height) return;
+        if (x < 0) { w += x; x = 0; }
+        if (x + w > width) w = width - x;
+        if (w <= 0) return;
+        applyMask(&buffer[(y >> 3) * width + x], w, 1 << (y & 7), color);
+    }
+
+    void drawVLine(int x, int y, int h, uint8_t color) override {
+        fillRect(x, y, 1, h, color);
+    }
+
+    void fillRect(int x, int y, int w, int h, uint8_t color) override {
+        if (x < 0) { w += x; x = 0; }
+        if (y < 0) { h += y; y = 0; }
+        if (x + w > width) w = width - x;
+        if (y + h > height) h = height - y;
+        if (w <= 0 || h <= 0) return;
+
+        int y1 = y + h - 1;
+        int firstPage = y >> 3;
+        int lastPage = y1 >> 3;
+        for (int page = firstPage; page <= lastPage; ++page) {
+            // 计算本页内被覆盖的行掩码
+            int top = (page == firstPage) ? (y & 7) : 0;
+            int bottom = (page == lastPage) ? (y1 & 7) : 7;
+            uint8_t mask = (uint8_t)((0xFF << top) & (0xFF >> (7 - bottom)));
+            applyMask(&buffer[page * width + x], w, mask, color);
+        }
+    }
+
+    void drawXBM(int x, int y, int w, int h, const uint8_t* bitmap) override {
+        int rowBytes = (w + 7) / 8;
+        for (int j = 0; j < h; ++j) {
+            int py = y + j;
+            if (py < 0 || py >= height) continue;
+            const uint8_t* row = bitmap + j * rowBytes;
+            uint8_t* dst = &buffer[(py >> 3) * width];
+            uint8_t bit = 1 << (py & 7);
+            for (int i = 0; i < w; ++i) {
+                int px = x + i;
+                if (px < 0 || px >= width) continue;
+                if (row[i >> 3] & (1 << (i & 7))) dst[px] |= bit;
+            }
+        }
+    }
+
+    int getWidth() const override { return width; }
+    int getHeight() const override { return height; }
+
+    /**
+     * @brief 帧缓冲本身不带字库，文本绘制为空操作
+     */
+    void drawStr(int x, int y, const char* s) override {
+        (void)x; (void)y; (void)s;
+    }
+
+    void drawStrN(int x, int y, const char* s, size_t n) override {
+        (void)x; (void)y; (void)s; (void)n;
+    }
+
+    /**
+     * @brief 估算文本宽度
+     * 按 ASCII 6px、其他字符 (如中文) 12px 估算，便于无头环境下的布局计算。
+     */
+    int getStrWidth(const char* s) override {
+        return getStrWidthN(s, strlen(s));
+    }
+
+    int getStrWidthN(const char* s, size_t n) override {
+        int w = 0;
+        for (size_t i = 0; i < n; ++i) {
+            uint8_t c = (uint8_t)s[i];
+            if (c < 0x80) w += 6;
+            else if ((c & 0xC0) != 0x80) w += 12; // UTF-8 多字节序列的首字节
+        }
+        return w;
+    }
+
+    unsigned long getMillis() override {
+        #ifdef ARDUINO
+        return millis();
+        #else
+        static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        #endif
+    }
+
+    unsigned long getMicros() override {
+        #ifdef ARDUINO
+        return micros();
+        #else
+        static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        #endif
+    }
+};
+
+} // namespace Hydrogen
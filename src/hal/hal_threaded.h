@@ -0,0 +1,115 @@
+#pragma once
+#include "hal_framebuffer.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Hydrogen {
+
+/**
+ * @brief 由工作线程异步传输的双缓冲帧缓冲 (主机端)
+ *
+ * beginFlush() 把传输交给工作线程后立即返回，主线程接着渲染下一帧，用于在主机上
+ * 验证和测量渲染与屏幕传输的重叠。依赖 std::thread：以 HYDROGEN_HOST_THREADS=1 编译时由 HydrogenUI.h 包含，
+ * 也可以直接包含本文件。工作线程按设定的总线速率休眠来模拟传输耗时
+ * (与 DMA 一样不占用 CPU)，然后调用刷新回调 (回调在工作线程中执行，应读取 getFrontBuffer())。
+ * 关闭双缓冲 (setDoubleBuffered(false)) 后退化为同步刷新，update()/updateRegion() 在调用线程中
+ * 按同样的速率等待，便于对照。
+ *
+ * @code
+ *   ThreadedFramebufferHAL hal(128, 64, 8000000 / 8); // 模拟 8 MHz SPI
+ *   App.begin(&hal);
+ * @endcode
+ */
+class ThreadedFramebufferHAL : public FramebufferHAL {
+    std::thread worker;
+    std::mutex lock;
+    std::condition_variable wake;  ///< 有新的传输或需要退出
+    std::condition_variable done;  ///< 传输完成
+    bool pending;
+    bool stopping;
+    int jobX, jobPage, jobW, jobPages;
+    unsigned long bytesPerSecond;  ///< 模拟的总线速率，0 表示不模拟耗时
+
+    /**
+     * @brief 按总线速率等待 bytes 字节的传输时间
+     */
+    void simulateBus(unsigned long bytes) {
+        unsigned long bps;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            bps = bytesPerSecond;
+        }
+        if (bps > 0) std::this_thread::sleep_for(std::chrono::microseconds(bytes * 1000000ULL / bps));
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> guard(lock);
+        for (;;) {
+            wake.wait(guard, [this] { return pending || stopping; });
+            if (stopping) return;
+            pending = false;
+            int x = jobX, page = jobPage, w = jobW, pageCount = jobPages;
+            guard.unlock();
+
+            simulateBus((unsigned long)w * pageCount);
+            transfer(x, page, w, pageCount);
+
+            guard.lock();
+            finishFlush();
+            done.notify_all();
+        }
+    }
+
+protected:
+    void syncTransfer(int x, int page, int w, int pageCount) override {
+        simulateBus((unsigned long)w * pageCount);
+        transfer(x, page, w, pageCount);
+    }
+
+    void startTransfer(int x, int page, int w, int pageCount) override {
+        std::lock_guard<std::mutex> guard(lock);
+        jobX = x;
+        jobPage = page;
+        jobW = w;
+        jobPages = pageCount;
+        pending = true;
+        wake.notify_one();
+    }
+
+public:
+    /**
+     * @param bytesPerSecond 模拟的总线速率 (字节/秒)，0 表示传输不耗时
+     */
+    ThreadedFramebufferHAL(int width, int height, unsigned long bytesPerSecond = 0)
+        : FramebufferHAL(width, height), pending(false), stopping(false),
+          jobX(0), jobPage(0), jobW(0), jobPages(0), bytesPerSecond(bytesPerSecond) {
+        setDoubleBuffered(true);
+        worker = std::thread(&ThreadedFramebufferHAL::run, this);
+    }
+
+    ~ThreadedFramebufferHAL() override {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    /**
+     * @brief 设置模拟的总线速率 (字节/秒)，从下一次传输开始生效
+     */
+    void setBusSpeed(unsigned long bps) {
+        std::lock_guard<std::mutex> guard(lock);
+        bytesPerSecond = bps;
+    }
+
+    void waitFlush() override {
+        std::unique_lock<std::mutex> guard(lock);
+        done.wait(guard, [this] { return isFlushDone(); });
+    }
+};
+
+} // namespace Hydrogen
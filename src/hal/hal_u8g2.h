@@ -1,8 +1,11 @@
 #pragma once
 #include "hal.h"
+#include "frame_diff.h"
 #include <U8g2lib.h>
 #ifdef ARDUINO
 #include <Arduino.h>
+#else
+#include <chrono>
 #endif
 
 namespace Hydrogen {
@@ -10,27 +13,170 @@ namespace Hydrogen {
 class U8g2HAL : public HAL {
 private:
     U8G2* u8g2;
+    uint8_t drawColor; ///< 缓存的绘图颜色，避免重复调用 setDrawColor
+    FrameDiffer* differ; ///< 帧差分，nullptr 表示不比较
+    unsigned long bytesSent;
+
+    U8g2HAL(const U8g2HAL&);
+    U8g2HAL& operator=(const U8g2HAL&);
+
+    void setColor(uint8_t color) {
+        if (color != drawColor) {
+            u8g2->setDrawColor(color);
+            drawColor = color;
+        }
+    }
+
+    /**
+     * @brief 经帧差分推送一块 Tile 对齐的区域 (x、w 以列计，page 以页计)
+     */
+    void flushDiff(int x, int page, int w, int pageCount) {
+        differ->flush(u8g2->getBufferPtr(), x, page, w, pageCount, [this](int rx, int rpage, int rw, int rpages) {
+            u8g2->updateDisplayArea(rx / 8, rpage, (rw + 7) / 8, rpages);
+            bytesSent += (unsigned long)rw * rpages;
+        });
+    }
+
+    /**
+     * @brief 是否为页缓冲模式 (_1_/_2_ 构造函数)：缓冲区只有一两页高，updateDisplayArea 无法使用
+     */
+    bool isPageBuffered() const {
+        return u8g2->getBufferTileHeight() != u8g2->getU8x8()->display_info->tile_height;
+    }
 
 public:
-    explicit U8g2HAL(U8G2* u8g2_instance) : u8g2(u8g2_instance) {}
+    explicit U8g2HAL(U8G2* u8g2_instance) : u8g2(u8g2_instance), drawColor(0xFF), differ(nullptr), bytesSent(0) {}
+
+    ~U8g2HAL() override { delete differ; }
 
     void init() override {
         u8g2->begin();
+        if (differ) differ->invalidate();
     }
 
+    /**
+     * @brief 开启或关闭帧差分：刷新时只推送与上次送出的画面不同的 Tile (适合 I2C 屏)
+     * 需要全缓冲模式 (_F_ 构造函数)、U8G2_R0 以及 SSD1306 这类页布局 (vertical_top_lsb) 的控制器，
+     * 条件不满足时保持关闭。
+     * @return 帧差分是否已开启
+     */
+    bool setDiffing(bool on) {
+        u8g2_t* s = u8g2->getU8g2();
+        if (on && (s->cb != U8G2_R0 || s->ll_hvline != u8g2_ll_hvline_vertical_top_lsb || !u8g2->getBufferPtr() ||
+                   isPageBuffered())) {
+            on = false;
+        }
+        if (on != (differ != nullptr)) {
+            delete differ;
+            differ = on ? new FrameDiffer(u8g2->getBufferTileWidth() * 8, u8g2->getBufferTileHeight()) : nullptr;
+        }
+        return on;
+    }
+
+    bool isDiffing() const { return differ != nullptr; }
+
+    /**
+     * @brief 累计推送的字节数
+     */
+    unsigned long getBytesSent() const { return bytesSent; }
+
     void clear() override {
         u8g2->clearBuffer();
+        // 用户代码可能在帧之间直接修改了 u8g2 的绘图颜色，每帧重新同步一次
+        drawColor = 0xFF;
     }
 
     void update() override {
+        if (differ) {
+            flushDiff(0, 0, u8g2->getBufferTileWidth() * 8, u8g2->getBufferTileHeight());
+            return;
+        }
         u8g2->sendBuffer();
+        bytesSent += (unsigned long)u8g2->getBufferTileWidth() * 8 * u8g2->getBufferTileHeight();
+    }
+
+    /**
+     * @brief 按 8x8 Tile 局部刷新
+     * updateDisplayArea 只适用于全缓冲模式 (_F_ 构造函数)，且使用未旋转的缓冲区坐标，
+     * 因此页缓冲模式或非 U8G2_R0 时回退整屏刷新 (sendBuffer)。
+     */
+    void updateRegion(int x, int y, int w, int h) override {
+        if (u8g2->getU8g2()->cb != U8G2_R0 || isPageBuffered()) {
+            update();
+            return;
+        }
+        if (x < 0) { w += x; x = 0; }
+        if (y < 0) { h += y; y = 0; }
+        if (x + w > getWidth()) w = getWidth() - x;
+        if (y + h > getHeight()) h = getHeight() - y;
+        if (w <= 0 || h <= 0) return;
+
+        int tx0 = x / 8;
+        int ty0 = y / 8;
+        int tx1 = (x + w + 7) / 8;
+        int ty1 = (y + h + 7) / 8;
+        if (differ) {
+            flushDiff(tx0 * 8, ty0, (tx1 - tx0) * 8, ty1 - ty0);
+            return;
+        }
+        u8g2->updateDisplayArea(tx0, ty0, tx1 - tx0, ty1 - ty0);
+        bytesSent += (unsigned long)(tx1 - tx0) * 8 * (ty1 - ty0);
     }
 
     void drawPixel(int x, int y, uint8_t color) override {
-        u8g2->setDrawColor(color);
+        setColor(color);
         u8g2->drawPixel(x, y);
     }
 
+    // u8g2 使用无符号坐标，负坐标会回绕并被整段丢弃，因此批量接口需要先裁剪到屏幕范围
+    void drawHLine(int x, int y, int w, uint8_t color) override {
+        fillRect(x, y, w, 1, color);
+    }
+
+    void drawVLine(int x, int y, int h, uint8_t color) override {
+        fillRect(x, y, 1, h, color);
+    }
+
+    void fillRect(int x, int y, int w, int h, uint8_t color) override {
+        if (x < 0) { w += x; x = 0; }
+        if (y < 0) { h += y; y = 0; }
+        if (x + w > getWidth()) w = getWidth() - x;
+        if (y + h > getHeight()) h = getHeight() - y;
+        if (w <= 0 || h <= 0) return;
+        setColor(color);
+        if (h == 1) {
+            u8g2->drawHLine(x, y, w);
+        } else if (w == 1) {
+            u8g2->drawVLine(x, y, h);
+        } else {
+            u8g2->drawBox(x, y, w, h);
+        }
+    }
+
+    void drawXBM(int x, int y, int w, int h, const uint8_t* bitmap) override {
+        if (x < 0 || y < 0) {
+            // 部分位于屏幕左/上方，退回逐点绘制
+            HAL::drawXBM(x, y, w, h, bitmap);
+            return;
+        }
+        setColor(1);
+        // 透明模式：只绘制为 1 的位。u8g2 对象与应用共享，绘制后恢复原来的模式
+        uint8_t mode = u8g2->getU8g2()->bitmap_transparency;
+        u8g2->setBitmapMode(1);
+        u8g2->drawXBM(x, y, w, h, bitmap);
+        u8g2->setBitmapMode(mode);
+    }
+
+    void setClipWindow(int x, int y, int w, int h) override {
+        if (x <= 0 && y <= 0 && x + w >= getWidth() && y + h >= getHeight()) {
+            u8g2->setMaxClipWindow();
+        } else if (w <= 0 || h <= 0) {
+            u8g2->setClipWindow(0, 0, 0, 0); // 空窗口，不绘制任何内容
+        } else {
+            u8g2->setClipWindow(x, y, x + w, y + h); // 右下角坐标不包含在内
+        }
+    }
+
     int getWidth() const override {
         return u8g2->getDisplayWidth();
     }
@@ -40,7 +186,7 @@ public:
     }
 
     void drawStr(int x, int y, const char* s) override {
-        u8g2->setDrawColor(1);
+        setColor(1);
         u8g2->drawUTF8(x, y, s);
     }
 
@@ -48,11 +194,27 @@ public:
         return u8g2->getUTF8Width(s);
     }
 
+    const void* getFontId() override {
+        return u8g2->getU8g2()->font; // setFont() 修改的字库指针
+    }
+
     unsigned long getMillis() override {
         #ifdef ARDUINO
         return millis();
         #else
-        return 0; // Fallback or implement for other platforms
+        static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        #endif
+    }
+
+    unsigned long getMicros() override {
+        #ifdef ARDUINO
+        return micros();
+        #else
+        static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
         #endif
     }
 };
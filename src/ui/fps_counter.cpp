@@ -1,26 +1,70 @@
 #include "fps_counter.h"
-#include <cstdio>
+#include "../core/app.h"
+#include "../core/format.h"
+#include <cstring>
 
 namespace Hydrogen {
 
-void FPSCounter::draw(Graphics& g) {
-    if (!visible) return;
+void FPSCounter::update() {
+    HAL* hal = App.getHAL();
+    if (!hal) return;
 
-    // 计算 FPS
-    unsigned long now = g.getHAL()->getMillis();
-    frameCount++;
-    
     // 每秒更新一次
-    if (now - lastTime >= 1000) {
-        fps = frameCount;
-        frameCount = 0;
-        lastTime = now;
+    unsigned long now = hal->getMillis();
+    if (now - lastTime < 1000 && text[0] != '\0') return;
+
+    fps = (int)(App.getFrameCount() - lastFrames);
+    skipped = (int)(App.getSkippedFrames() - lastSkipped);
+    lastFrames = App.getFrameCount();
+    lastSkipped = App.getSkippedFrames();
+    lastTime = now;
+
+    // 格式化 FPS 字符串 (栈上拼接，不使用 snprintf)
+    char buf[sizeof(text)];
+    TextBuilder out(buf, sizeof(buf));
+    out.append("FPS: ").append(fps);
+    if (showSkipped) out.append(" S: ").append(skipped);
+#if HYDROGEN_ENABLE_STATS
+    updateStats();
+#endif
+    if (strcmp(buf, text) == 0) return;
+
+    // 新旧文本宽度可能不同，按较宽者上报 (文本高度约 12px，基线在 y+10)
+    int newWidth = App.getGraphics()->getTextWidth(buf);
+    int dirtyWidth = newWidth > textWidth ? newWidth : textWidth;
+    App.invalidateScreen(Rect{bounds.x, bounds.y, dirtyWidth, 13});
+
+    memcpy(text, buf, sizeof(text));
+    textWidth = newWidth;
+}
+
+#if HYDROGEN_ENABLE_STATS
+void FPSCounter::updateStats() {
+    const FrameStats& stats = App.getStats();
+    char buf[sizeof(statsText)];
+    TextBuilder out(buf, sizeof(buf));
+    // 关闭后文本为空，擦除之前显示的第二行
+    if (showStats) {
+        out.append("U:").append(stats.getPhase(FrameStats::Phase::Update).getAvg());
+        out.append(" D:").append(stats.getPhase(FrameStats::Phase::Clear).getAvg() +
+                                 stats.getPhase(FrameStats::Phase::Draw).getAvg());
+        out.append(" F:").append(stats.getPhase(FrameStats::Phase::Flush).getAvg());
     }
+    if (strcmp(buf, statsText) == 0) return;
+
+    // 第二行在第一行下方 12px
+    int newWidth = App.getGraphics()->getTextWidth(buf);
+    int dirtyWidth = newWidth > statsWidth ? newWidth : statsWidth;
+    App.invalidateScreen(Rect{bounds.x, bounds.y + 12, dirtyWidth, 13});
+
+    memcpy(statsText, buf, sizeof(statsText));
+    statsWidth = newWidth;
+}
+#endif
+
+void FPSCounter::draw(Graphics& g) {
+    if (!visible) return;
 
-    // 格式化 FPS 字符串
-    char buf[16];
-    snprintf(buf, sizeof(buf), "FPS: %d", fps);
-    
     // 以 HUD (平视显示器) 模式绘制
     // 忽略相机的平移，确保 FPS 始终显示在屏幕固定位置
     int oldCamX = g.getCamX();
@@ -31,7 +75,10 @@ void FPSCounter::draw(Graphics& g) {
     // g.fillRect(bounds.x, bounds.y, 50, 12);
     
     // 绘制文本 (y+10 是为了基线对齐)
-    g.drawText(bounds.x, bounds.y + 10, std::string(buf));
+    g.drawText(bounds.x, bounds.y + 10, text);
+#if HYDROGEN_ENABLE_STATS
+    if (showStats) g.drawText(bounds.x, bounds.y + 22, statsText);
+#endif
     
     g.setCamera(oldCamX, oldCamY); // 恢复相机
 }
@@ -10,12 +10,33 @@ namespace Hydrogen {
  * 
  * 一个简单的调试控件，用于显示当前的屏幕刷新率。
  * 建议在开发阶段使用，以监控性能。
+ *
+ * 帧数取自 Application 的统计：只有真正绘制并刷新的帧才计入 FPS。
+ * 开启 setShowSkipped() 后同时显示每秒因画面无变化而跳过的帧数。
+ * 以 HYDROGEN_ENABLE_STATS=1 编译时，setShowStats() 在第二行显示 FrameStats 的阶段耗时。
  */
 class FPSCounter : public Widget {
 private:
-    unsigned long lastTime; ///< 上次统计的时间戳
-    int frameCount;         ///< 当前时间窗口内的帧数累积
-    int fps;                ///< 计算出的 FPS 值
+    unsigned long lastTime;    ///< 上次统计的时间戳
+    unsigned long lastFrames;  ///< 上次统计时 App 的已绘制帧数
+    unsigned long lastSkipped; ///< 上次统计时 App 的已跳过帧数
+    int fps;                   ///< 计算出的 FPS 值
+    int skipped;               ///< 每秒跳过的帧数
+    bool showSkipped;          ///< 是否显示跳过帧数
+    char text[24];             ///< 当前显示的文本
+    int textWidth;             ///< 当前文本的像素宽度
+#if HYDROGEN_ENABLE_STATS
+    bool showStats;            ///< 是否显示阶段耗时
+    char statsText[24];        ///< 第二行文本
+    int statsWidth;            ///< 第二行文本的像素宽度
+#endif
+
+#if HYDROGEN_ENABLE_STATS
+    /**
+     * @brief 刷新第二行的阶段耗时 (关闭时为空)，内容变化时上报所在区域
+     */
+    void updateStats();
+#endif
 
 public:
     /**
@@ -23,11 +44,45 @@ public:
      * @param x 显示位置 X
      * @param y 显示位置 Y
      */
-    FPSCounter(int x, int y) : Widget(x, y, 0, 0), lastTime(0), frameCount(0), fps(0) {}
+    FPSCounter(int x, int y)
+        : Widget(x, y, 0, 0), lastTime(0), lastFrames(0), lastSkipped(0),
+          fps(0), skipped(0), showSkipped(false), textWidth(0) {
+        text[0] = '\0';
+#if HYDROGEN_ENABLE_STATS
+        showStats = false;
+        statsText[0] = '\0';
+        statsWidth = 0;
+#endif
+    }
+
+    /**
+     * @brief 是否在 FPS 后显示每秒跳过的空闲帧数 (如 "FPS: 12 S: 48")
+     */
+    void setShowSkipped(bool show) {
+        showSkipped = show;
+        text[0] = '\0'; // 强制下次 update 刷新文本
+    }
+
+#if HYDROGEN_ENABLE_STATS
+    /**
+     * @brief 是否在第二行显示最近各帧的平均阶段耗时 (微秒)，如 "U:120 D:850 F:400"
+     * 分别为逻辑更新、清除与绘制、刷新。详细数据用 FrameStats::dump() 输出。
+     */
+    void setShowStats(bool show) {
+        showStats = show;
+        text[0] = '\0'; // 强制下次 update 刷新文本
+    }
+#endif
+
+    /**
+     * @brief 每秒结算一次 FPS
+     * 显示内容变化时上报文本所在的屏幕区域
+     */
+    void update() override;
 
     /**
      * @brief 绘制方法
-     * 自动统计并显示 FPS
+     * 显示最近一次统计的 FPS
      */
     void draw(Graphics& g) override;
 };
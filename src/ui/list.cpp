@@ -1,70 +1,435 @@
 #include "list.h"
-#include <cmath>
+#include "../core/format.h"
+#include <algorithm>
+#include <string.h>
 
 namespace Hydrogen {
 
-void List::addItem(const std::string& item) {
-    items.push_back(new Label(0, 0, item));
+void ListRow::setText(const char* s) {
+    TextBuilder(text, sizeof(text)).append(s);
+}
+
+void ListRow::draw(Graphics& g) {
+    if (!visible) return;
+    g.drawText(bounds.x, bounds.y, text); // List 把 y 设为基线
+}
+
+namespace {
+
+/**
+ * @brief text 是否以 prefix 开头 (不区分 ASCII 大小写)
+ */
+bool startsWithNoCase(const char* text, const char* prefix) {
+    for (; *prefix; ++text, ++prefix) {
+        char a = *text, b = *prefix;
+        if (a >= 'A' && a <= 'Z') a += 'a' - 'A';
+        if (b >= 'A' && b <= 'Z') b += 'a' - 'A';
+        if (a != b) return false; // 含 text 先结束的情况
+    }
+    return true;
+}
+
+/**
+ * @brief 比较 text 的前 strlen(prefix) 字节与 prefix (不区分 ASCII 大小写)，返回值同 strcmp
+ */
+int compareNoCase(const char* text, const char* prefix) {
+    for (; *prefix; ++text, ++prefix) {
+        int a = (uint8_t)*text, b = (uint8_t)*prefix;
+        if (a >= 'A' && a <= 'Z') a += 'a' - 'A';
+        if (b >= 'A' && b <= 'Z') b += 'a' - 'A';
+        if (a != b) return a - b;
+    }
+    return 0;
+}
+
+} // namespace
+
+void List::addItem(const TextValue& item) {
+    addItem(makeWidget<Label>(arenaFor(), 0, 0, item));
 }
 
 void List::addItem(Widget* widget) {
     items.push_back(widget);
+    if (!source) {
+        int item = (int)items.size() - 1;
+        if (!filter[0] || (!isItemSection(item) && startsWithNoCase(widget->getText(), filter))) appendRow(item);
+    }
+    // 列表内容随相机滚动，自身 bounds 并不代表可见区域，直接整屏重绘
+    App.invalidateAll();
 }
 
-void List::next() {
-    if (items.empty()) return;
-    int originalIndex = selectedIndex;
-    
-    // 尝试寻找下一个可交互的项
-    int nextIndex = selectedIndex;
-    do {
-        if (nextIndex < (int)items.size() - 1) {
-            nextIndex++;
-        } else {
-            nextIndex = 0; // 循环回顶部
+void List::addSection(const TextValue& title) {
+    // 先登记再添加，appendRow 据此把标题排除在可交互行之外
+    sectionItems.push_back((int)items.size());
+    addItem(makeWidget<Label>(arenaFor(), 0, 0, title));
+}
+
+void List::clear() {
+    for (auto item : items) {
+        delete item;
+    }
+    items.clear();
+    if (!source) sectionItems.clear();
+    selectedIndex = 0;
+    measuredIndex = -1;
+    reloadData();
+    App.invalidateAll();
+}
+
+void List::releaseRows() {
+    for (auto row : rows) {
+        delete row;
+    }
+    rows.clear();
+    rowIndex.clear();
+}
+
+void List::ensureRows() {
+    // 可见行数 + 上下各一行部分可见
+    int minHeight = layout.getMinHeight();
+    int needed = bounds.h / (minHeight > 0 ? minHeight : 1) + 2;
+    rows.reserve(needed);
+    while ((int)rows.size() < needed) {
+        Widget* row = source->createRow();
+        customRows = row != nullptr;
+        if (!row) row = makeWidget<ListRow>(arenaFor());
+        rows.push_back(row);
+    }
+    // 行控件数变了，第 i 项对应的控件也随之改变
+    rowIndex.assign(rows.size(), -1);
+}
+
+void List::setDataSource(ListDataSource* dataSource) {
+    releaseRows();
+    source = dataSource;
+    customRows = false;
+    selectedIndex = 0;
+    filter[0] = '\0';
+    reloadData();
+}
+
+void List::reloadData() {
+    // 数据源的分组标题在这里重新读取；addSection 登记的标题保持不变
+    if (source) {
+        sectionItems.clear();
+        int count = source->count();
+        for (int i = 0; i < count; ++i) {
+            if (source->isSection(i)) sectionItems.push_back(i);
         }
-        
-        // 如果找到了可交互的项，或者循环回到了原点（避免死循环）
-        if (items[nextIndex]->isInteractive() || nextIndex == originalIndex) {
-            selectedIndex = nextIndex;
-            return;
+    }
+    int selectedItem = getSelectedIndex();
+
+    // 过滤模式下按当前前缀重新扫描全部列表项
+    filtered.clear();
+    if (filter[0]) {
+        int count = source ? source->count() : (int)items.size();
+        for (int i = 0; i < count; ++i) {
+            if (!isItemSection(i) && startsWithNoCase(itemText(i), filter)) filtered.push_back(i);
         }
-    } while (nextIndex != originalIndex);
+    }
+    rebuildView();
+
+    // 选中项仍在视图中则保持；不过滤时越界的选中项收拢到最后一行
+    int row = toRow(selectedItem);
+    if (row < 0) row = filter[0] ? 0 : selectedItem;
+    selectRow(row);
+}
+
+void List::rebuildView() {
+    layout.reset(0, itemHeight);
+    interactiveRows.clear();
+    allInteractive = true;
+
+    int count = filter[0] ? (int)filtered.size() : (source ? source->count() : (int)items.size());
+    const uint16_t* offsets = source && !filter[0] ? source->rowOffsets() : nullptr;
+    if (offsets) {
+        // 数据源自带偏移表，只需建立可交互行索引
+        layout.setOffsets(offsets, count);
+        interactiveRows.reserve(count);
+        for (int i = 0; i < count; ++i) indexRow(i, i);
+    } else if (filter[0]) {
+        // appendRow 会追加到 filtered，先取出已筛选的结果
+        std::vector<int> view;
+        view.swap(filtered);
+        for (int i = 0; i < count; ++i) appendRow(view[i]);
+    } else {
+        for (int i = 0; i < count; ++i) appendRow(i);
+    }
+
+    if (source) ensureRows();
+    measuredIndex = -1;
+    App.invalidateAll();
+}
+
+void List::appendRow(int item) {
+    int row = layout.getCount();
+    if (filter[0]) filtered.push_back(item);
+    layout.append(itemHeightOf(item));
+    indexRow(item, row);
+}
+
+void List::indexRow(int item, int row) {
+    // 全部可交互时不保存索引；出现第一个不可交互的行时才展开
+    bool interactive = isItemInteractive(item);
+    if (allInteractive && !interactive) {
+        allInteractive = false;
+        for (int i = 0; i < row; ++i) interactiveRows.push_back(i);
+    } else if (!allInteractive && interactive) {
+        interactiveRows.push_back(row);
+    }
+}
+
+int List::toRow(int item) const {
+    if (!filter[0]) return item >= 0 && item < getItemCount() ? item : -1;
+    std::vector<int>::const_iterator it = std::lower_bound(filtered.begin(), filtered.end(), item);
+    return it != filtered.end() && *it == item ? (int)(it - filtered.begin()) : -1;
+}
+
+void List::setRowHeight(int index, int height) {
+    int row = toRow(index);
+    if (row < 0 || height == layout.heightOf(row)) return;
+    layout.setHeight(row, height);
+    if (source && (int)rows.size() < bounds.h / (height > 0 ? height : 1) + 2) ensureRows();
+    App.invalidateAll();
+}
+
+int List::getRowHeight(int index) const {
+    int row = toRow(index);
+    return row >= 0 ? layout.heightOf(row) : 0;
+}
+
+bool List::isItemSection(int item) const {
+    return std::binary_search(sectionItems.begin(), sectionItems.end(), item);
+}
+
+bool List::isItemInteractive(int item) const {
+    if (isItemSection(item)) return false;
+    return source ? source->isInteractive(item) : items[item]->isInteractive();
+}
+
+const char* List::itemText(int item) const {
+    return source ? source->textAt(item) : items[item]->getText();
+}
+
+int List::itemHeightOf(int item) const {
+    int h = source ? source->heightAt(item) : items[item]->getBounds().h;
+    return h > 0 ? h : itemHeight;
+}
+
+bool List::isRowInteractive(int row) const {
+    if (allInteractive) return row >= 0 && row < getItemCount();
+    return std::binary_search(interactiveRows.begin(), interactiveRows.end(), row);
+}
+
+int List::firstInteractiveFrom(int row) const {
+    if (allInteractive) return row < getItemCount() ? row : -1;
+    std::vector<int>::const_iterator it = std::lower_bound(interactiveRows.begin(), interactiveRows.end(), row);
+    return it != interactiveRows.end() ? *it : -1;
+}
+
+Widget* List::itemAt(int row) {
+    if (!source) return items[toItem(row)];
+
+    // 可见范围不超过 rows.size() 行，连续的行不会争用同一个行控件
+    int slot = row % (int)rows.size();
+    Widget* w = rows[slot];
+    if (rowIndex[slot] != row) {
+        int item = toItem(row);
+        if (!customRows) static_cast<ListRow*>(w)->setText(source->textAt(item));
+        source->bindWidget(item, *w);
+        rowIndex[slot] = row;
+    }
+    return w;
+}
+
+int List::contentWidth(int row) {
+    Widget* w = nullptr;
+    if (!source) {
+        w = items[toItem(row)];
+    } else {
+        int slot = row % (int)rows.size();
+        if (rowIndex[slot] == row) w = rows[slot];
+    }
+    int contentW = w ? w->getBounds().w : 0;
+
+    // 如果是 Label (宽度为0)，则计算文本宽度
+    // 同一项的文本不会变，只在选中项改变时测量一次
+    if (contentW == 0) {
+        if (measuredIndex != row) {
+            measuredWidth = App.getGraphics()->getTextWidth(itemText(toItem(row)));
+            measuredIndex = row;
+        }
+        contentW = measuredWidth;
+        // 如果有箭头，需要加上箭头的宽度
+        // 这里无法直接判断是否是 Label 并有箭头，但我们可以给额外的 padding
+        // 或者通过 dynamic_cast (如果开启了 RTTI)
+        // 简单起见，统一给比较大的 padding
+    }
+    return contentW;
+}
+
+Rect List::selectionBox() const {
+    return Rect{bounds.x + 2, bounds.y + targetSelectY + scalarRound(selectOffsetY), scalarRound(selectWidth),
+                scalarRound(selectHeight)};
+}
+
+void List::selectionMoved(void* list) {
+    List* self = static_cast<List*>(list);
+    Rect box = self->selectionBox();
+    const Rect& old = self->shownBox;
+    if (box.x != old.x || box.y != old.y || box.w != old.w || box.h != old.h) {
+        self->invalidate(old);
+        self->invalidate(box);
+        self->shownBox = box;
+    }
+}
+
+void List::selectRow(int row) {
+    int count = getItemCount();
+    if (row >= count) row = count - 1;
+    if (row < 0) row = 0;
+    selectedIndex = row;
+}
+
+void List::next() {
+    int count = getItemCount();
+    if (count == 0) return;
+
+    // 下一个可交互的行，到达底部后回到顶部；没有其他可交互的行时保持不动
+    int row = firstInteractiveFrom(selectedIndex + 1);
+    if (row < 0) row = firstInteractiveFrom(0);
+    if (row >= 0) selectedIndex = row;
 }
 
 void List::prev() {
-    if (items.empty()) return;
-    int originalIndex = selectedIndex;
-    
-    // 尝试寻找上一个可交互的项
-    int prevIndex = selectedIndex;
-    do {
-        if (prevIndex > 0) {
-            prevIndex--;
-        } else {
-            prevIndex = items.size() - 1; // 循环到底部
+    int count = getItemCount();
+    if (count == 0) return;
+
+    // 上一个可交互的行，到达顶部后跳到底部
+    int row = -1;
+    if (allInteractive) {
+        row = selectedIndex > 0 ? selectedIndex - 1 : count - 1;
+    } else if (!interactiveRows.empty()) {
+        std::vector<int>::const_iterator it =
+            std::lower_bound(interactiveRows.begin(), interactiveRows.end(), selectedIndex);
+        row = it != interactiveRows.begin() ? *(it - 1) : interactiveRows.back();
+    }
+    if (row >= 0) selectedIndex = row;
+}
+
+void List::nextSection() {
+    if (filter[0] || sectionItems.empty()) return;
+
+    // 下一个标题 (循环)，再取其后第一个可交互的行
+    std::vector<int>::const_iterator it = std::upper_bound(sectionItems.begin(), sectionItems.end(), selectedIndex);
+    int header = it != sectionItems.end() ? *it : sectionItems.front();
+    int row = firstInteractiveFrom(header);
+    if (row < 0) row = firstInteractiveFrom(0);
+    if (row >= 0) selectedIndex = row;
+}
+
+void List::prevSection() {
+    if (filter[0] || sectionItems.empty()) return;
+
+    // 当前所在分组的标题 (selectedIndex 之前最近的一个)
+    std::vector<int>::const_iterator it = std::upper_bound(sectionItems.begin(), sectionItems.end(), selectedIndex);
+    int current = it != sectionItems.begin() ? (int)(it - sectionItems.begin()) - 1 : -1;
+
+    // 已是本组第一项 (或在第一个标题之前) 时退到上一组
+    int header = current >= 0 ? sectionItems[current] : -1;
+    if (current < 0 || firstInteractiveFrom(header) == selectedIndex) {
+        current = current > 0 ? current - 1 : (int)sectionItems.size() - 1;
+        header = sectionItems[current];
+    }
+    int row = firstInteractiveFrom(header);
+    if (row >= 0) selectedIndex = row;
+}
+
+bool List::jumpTo(const char* prefix) {
+    int count = getItemCount();
+    if (!prefix || !*prefix || count == 0) return false;
+
+    int from = 0;
+    int to = count;
+    bool bySection = !filter[0] && !sectionItems.empty();
+    if (bySection) {
+        // 二分查找最后一个不大于 prefix 的标题，只在该分组内查找
+        int lo = 0;
+        int hi = (int)sectionItems.size() - 1;
+        int found = 0;
+        while (lo <= hi) {
+            int mid = (lo + hi) >> 1;
+            if (compareNoCase(itemText(sectionItems[mid]), prefix) <= 0) {
+                found = mid;
+                lo = mid + 1;
+            } else {
+                hi = mid - 1;
+            }
         }
-        
-        // 如果找到了可交互的项，或者循环回到了原点
-        if (items[prevIndex]->isInteractive() || prevIndex == originalIndex) {
-            selectedIndex = prevIndex;
-            return;
+        from = sectionItems[found];
+        to = found + 1 < (int)sectionItems.size() ? sectionItems[found + 1] : count;
+    }
+
+    for (int row = firstInteractiveFrom(from); row >= 0 && row < to; row = firstInteractiveFrom(row + 1)) {
+        if (startsWithNoCase(itemText(toItem(row)), prefix)) {
+            selectedIndex = row;
+            return true;
+        }
+    }
+
+    // 组内没有匹配项时停在该组的第一项
+    int row = firstInteractiveFrom(from);
+    if (bySection && row >= 0 && row < to) selectedIndex = row;
+    return false;
+}
+
+void List::setFilter(const char* prefix) {
+    if (!prefix) prefix = "";
+    int selectedItem = getSelectedIndex();
+    char previous[FILTER_CAPACITY];
+    memcpy(previous, filter, sizeof(filter));
+    TextBuilder(filter, sizeof(filter)).append(prefix);
+    if (strcmp(previous, filter) == 0) return;
+
+    if (!filter[0]) {
+        filtered.clear();
+    } else if (previous[0] && startsWithNoCase(filter, previous)) {
+        // 继续输入：新结果是旧结果的子集，原地筛选
+        size_t kept = 0;
+        for (size_t i = 0; i < filtered.size(); ++i) {
+            if (startsWithNoCase(itemText(filtered[i]), filter)) filtered[kept++] = filtered[i];
         }
-    } while (prevIndex != originalIndex);
+        filtered.resize(kept);
+    } else {
+        filtered.clear();
+        int count = source ? source->count() : (int)items.size();
+        for (int i = 0; i < count; ++i) {
+            if (!isItemSection(i) && startsWithNoCase(itemText(i), filter)) filtered.push_back(i);
+        }
+    }
+    rebuildView();
+
+    // 选中项仍在视图中则保持，否则选中第一个可交互的结果
+    int row = toRow(selectedItem);
+    if (row < 0 || !isRowInteractive(row)) row = firstInteractiveFrom(0);
+    selectRow(row);
 }
 
 void List::update() {
-    // 更新所有子控件
-    for (auto w : items) {
+    // 更新所有子控件 (虚拟化模式下只有复用的行控件)
+    for (auto w : source ? rows : items) {
         w->update();
     }
+    int count = getItemCount();
 
     // 1. 相机逻辑 (列表平滑滚动)
     int screenCenterY = bounds.h / 2;
-    int itemCenterY = (selectedIndex * itemHeight) + (itemHeight / 2);
+    int selectedTop = layout.offsetOf(selectedIndex);
+    int selectedHeight = count > 0 ? layout.heightOf(selectedIndex) : itemHeight;
+    int itemCenterY = selectedTop + (selectedHeight / 2);
     int targetCamY = itemCenterY - screenCenterY;
     
-    int totalHeight = items.size() * itemHeight;
+    int totalHeight = layout.totalHeight();
     int maxCamY = totalHeight - bounds.h;
     
     if (totalHeight < bounds.h) {
@@ -78,95 +443,137 @@ void List::update() {
 
     App.getCamera().setTarget(0, targetCamY);
 
+    Animator& animator = App.getAnimator();
+
     // 2. 选中框位置动画 (Y轴)
-    targetSelectY = selectedIndex * itemHeight;
-    
-    // 使用缓动函数平滑移动
-    if (std::abs(targetSelectY - selectY) > 0.5f) {
-        selectY += (targetSelectY - selectY) * easing;
-    } else {
-        selectY = targetSelectY;
+    // 仅在目标改变时启动补间，之后的移动由 Animator 推进
+    // 目标以整数保存，补间推进相对目标的偏移 (长列表中的行偏移超出定点数的整数范围)
+    if (selectedTop != targetSelectY) {
+        selectOffsetY = retargetOffset(selectOffsetY, targetSelectY, selectedTop);
+        targetSelectY = selectedTop;
+        animator.animate(&selectOffsetY, Scalar(0), duration, Curve::EaseOut, selectionMoved, this);
+    }
+
+    // 选中框高度随选中行的行高变化
+    Scalar newSelectHeight = selectedHeight;
+    if (newSelectHeight != targetSelectHeight) {
+        targetSelectHeight = newSelectHeight;
+        if (selectHeight == Scalar(0)) {
+            selectHeight = targetSelectHeight; // 首次运行时直接到位
+            selectionMoved(this);
+        } else {
+            animator.animate(&selectHeight, targetSelectHeight, duration, Curve::EaseOut, selectionMoved, this);
+        }
     }
 
     // 3. 选中框宽度动画 (Width)
     // 根据内容宽度计算目标宽度
-    if (selectedIndex >= 0 && selectedIndex < (int)items.size()) {
-        Widget* w = items[selectedIndex];
-        
+    Scalar newSelectWidth = Scalar(0);
+    if (selectedIndex >= 0 && selectedIndex < count) {
         // 如果不可交互，理论上不应该被选中，但为了安全起见，这里做一个检查
         // 如果选中了不可交互项（例如刚初始化时），我们可以让选中框消失或者全宽显示
-        
-        int contentW = w->getBounds().w;
-        // 如果是 Label (宽度为0)，则计算文本宽度
-        if (contentW == 0) {
-             std::string s = w->toString();
-             if (!s.empty()) {
-                 contentW = App.getGraphics()->getHAL()->getStrWidth(s.c_str());
-                 // 如果有箭头，需要加上箭头的宽度
-                 // 这里无法直接判断是否是 Label 并有箭头，但我们可以给额外的 padding
-                 // 或者通过 dynamic_cast (如果开启了 RTTI)
-                 // 简单起见，统一给比较大的 padding
-             }
-        }
-        targetSelectWidth = contentW + 12; // 内容宽度 + 左右 padding (各 6px)
-    } else {
-        targetSelectWidth = 0;
+        newSelectWidth = contentWidth(selectedIndex) + 12; // 内容宽度 + 左右 padding (各 6px)
     }
 
-    // 首次运行时初始化宽度
-    if (selectWidth == 0) selectWidth = targetSelectWidth;
+    if (newSelectWidth != targetSelectWidth) {
+        targetSelectWidth = newSelectWidth;
+        if (selectWidth == Scalar(0)) {
+            // 首次运行时直接到位
+            selectWidth = targetSelectWidth;
+            selectionMoved(this);
+        } else {
+            animator.animate(&selectWidth, targetSelectWidth, duration, Curve::EaseOut, selectionMoved, this);
+        }
+    }
+}
 
-    // 使用缓动函数平滑缩放
-    if (std::abs(targetSelectWidth - selectWidth) > 0.5f) {
-        selectWidth += (targetSelectWidth - selectWidth) * easing;
-    } else {
-        selectWidth = targetSelectWidth;
+bool List::isAnimating() const {
+    // 选中项已改变但还未经过逻辑步长处理，同样视为动画中
+    if (targetSelectY != layout.offsetOf(selectedIndex)) return true;
+    if (selectOffsetY != Scalar(0) || selectWidth != targetSelectWidth || selectHeight != targetSelectHeight) return true;
+    for (auto w : source ? rows : items) {
+        if (w->isAnimating()) return true;
     }
+    return false;
 }
 
 std::string List::getSelectedItem() const {
-    if (selectedIndex >= 0 && selectedIndex < (int)items.size()) {
-        return items[selectedIndex]->toString();
+    if (selectedIndex >= 0 && selectedIndex < getItemCount()) {
+        return itemText(toItem(selectedIndex));
     }
     return "";
 }
 
+void List::click() {
+    if (getItemCount() == 0) return;
+    if (source) {
+        source->clickAt(toItem(selectedIndex));
+        refreshRows();
+        return;
+    }
+    items[toItem(selectedIndex)]->click();
+}
+
+void List::refreshRows() {
+    if (!source) return;
+    rowIndex.assign(rows.size(), -1);
+    measuredIndex = -1;
+    App.invalidateAll();
+}
+
+bool List::handleEvent(const InputEvent& e) {
+    switch (e.type) {
+    case InputEvent::Type::Encoder:
+        for (int i = 0; i < e.delta; ++i) next();
+        for (int i = 0; i > e.delta; --i) prev();
+        return true;
+    case InputEvent::Type::ButtonDown:
+        click();
+        return true;
+    default:
+        return false;
+    }
+}
+
 void List::draw(Graphics& g) {
     if (!visible) return;
 
+    // 列表在屏幕上占据 bounds 区域，内容随相机滚动
+    // 将选中框和列表项裁剪到该区域，部分可见的行只绘制可见部分
+    // 使用图形上下文的相机位置：降级时它可能落后于 Camera，裁剪、可见行与滚动条都要与实际绘制一致
+    int camY = g.getCamY();
+    g.pushClip(Rect{bounds.x, bounds.y + camY, bounds.w, bounds.h});
+
     // 绘制选中框 (动画效果)
     // 圆角矩形，半径 2px
-    // 使用 selectY 实现平滑移动
-    int boxY = bounds.y + (int)round(selectY);
-    int boxW = (int)round(selectWidth);
+    // 使用 selectOffsetY 实现平滑移动
+    Rect box = selectionBox();
     
     // 绘制圆角选中框
     // 左对齐 bounds.x，宽度动态变化
-    g.drawRoundRect(bounds.x + 2, boxY, boxW, itemHeight, 2);
+    g.drawRoundRect(box.x, box.y, box.w, box.h, 2);
     
     // 绘制文本项
     // 优化：仅绘制可见区域内的项
-    int camY = App.getCamera().getY();
     int screenH = bounds.h;
     
-    // 根据可视区域计算起始和结束索引
-    int startIdx = (camY - bounds.y) / itemHeight;
-    int endIdx = (camY - bounds.y + screenH) / itemHeight + 1;
-    
-    // 限制索引范围
-    if (startIdx < 0) startIdx = 0;
-    if (endIdx > (int)items.size()) endIdx = items.size();
+    // 根据可视区域 (内容偏移 camY ~ camY + screenH) 查找起始项，逐行向下直到超出可视区域
+    int count = getItemCount();
+    int startIdx = layout.indexAt(camY);
+    int bottom = bounds.y + camY + screenH;
 
-    int y = bounds.y + (startIdx * itemHeight);
-    for (int i = startIdx; i < endIdx; ++i) {
-        Widget* w = items[i];
+    int y = bounds.y + layout.offsetOf(startIdx);
+    // 行控件在列表自身的重绘中就位 (复用的行每次绑定都会移动)，不另外标记重绘
+    for (int i = startIdx; i < count && y < bottom; ++i) {
+        Widget* w = itemAt(i);
+        int rowH = layout.heightOf(i);
         
         // 简单的对齐逻辑：如果是 Label (宽度为0且有文本)，则按基线对齐 (y+12)
         // 否则按左上角对齐 (y)
         // 注意：如果是两行模式的 ProgressBar，需要特殊处理高度
-        if (w->getBounds().w == 0 && !w->toString().empty()) {
-             // 文本垂直居中 (y + itemHeight/2 + 4)
-             w->setPosition(bounds.x + 6, y + itemHeight/2 + 4);
+        if (w->getBounds().w == 0 && w->getText()[0] != '\0') {
+             // 文本垂直居中 (y + rowH/2 + 4)
+             w->placeAt(bounds.x + 6, y + rowH/2 + 4);
         } else {
             // 固定宽度的 Label (如二级菜单) 或其他控件
             // 对于 Label，如果宽度固定，我们希望它是垂直居中对齐的基线
@@ -200,15 +607,17 @@ void List::draw(Graphics& g) {
             // 这确实是个问题。为了统一，Label::draw 也应该自己处理垂直对齐。
             // 让我们修改 Label::draw。
             
-            w->setPosition(bounds.x + 6, y);
+            w->placeAt(bounds.x + 6, y);
         }
         w->draw(g);
-        y += itemHeight;
+        y += rowH;
     }
 
+    g.popClip();
+
     // 绘制滚动条 (静态显示在屏幕右侧)
     // 计算总高度和可视高度比例
-    int totalHeight = items.size() * itemHeight;
+    int totalHeight = layout.totalHeight();
     
     if (totalHeight > screenH) {
         // 计算滚动条高度
@@ -1,11 +1,100 @@
 #pragma once
 #include "widget.h"
+#include "list_layout.h"
 #include "../core/app.h"
 #include <vector>
 #include <string>
 
 namespace Hydrogen {
 
+/**
+ * @brief 列表数据源
+ *
+ * 供虚拟化列表 (List::setDataSource) 按需读取列表项，列表本身不保存任何一行的数据。
+ * 行数很多 (文件浏览、日志索引) 时，内存与每帧开销只与可见行数有关。
+ */
+class ListDataSource {
+public:
+    virtual ~ListDataSource() = default;
+
+    /**
+     * @brief 列表项总数
+     */
+    virtual int count() const = 0;
+
+    /**
+     * @brief 第 index 项的显示文本 (UTF-8)
+     * 返回的指针只需在下一次调用 textAt() 之前有效，可以指向数据源内部的临时缓冲区。
+     */
+    virtual const char* textAt(int index) const = 0;
+
+    /**
+     * @brief 第 index 项能否被选中
+     */
+    virtual bool isInteractive(int index) const { (void)index; return true; }
+
+    /**
+     * @brief 第 index 项的行高
+     * 返回 0 表示使用列表的默认行高。只在 List::reloadData() 时逐行读取。
+     */
+    virtual int heightAt(int index) const { (void)index; return 0; }
+
+    /**
+     * @brief 预先算好的行偏移表 (第 i 项为前 i 项的行高之和，共 count() + 1 项)
+     * 返回非 nullptr 时 List 直接使用该表 (可以位于 Flash)，不再逐行读取 heightAt()。
+     * 表需在下一次 reloadData() 之前有效。
+     */
+    virtual const uint16_t* rowOffsets() const { return nullptr; }
+
+    /**
+     * @brief 第 index 项是否为分组标题 (不可选中，用于 List::nextSection()/jumpTo())
+     */
+    virtual bool isSection(int index) const { (void)index; return false; }
+
+    /**
+     * @brief 创建一个行控件
+     * 返回 nullptr 表示使用默认的文本行 (ListRow)。返回的控件由 List 接管，
+     * 每个可见行位置创建一个，滚动时通过 bindWidget() 复用。
+     */
+    virtual Widget* createRow() { return nullptr; }
+
+    /**
+     * @brief 把行控件绑定到第 index 项
+     * 默认的文本行在调用前已经填好了 textAt(index)；自定义行 (createRow) 需在此更新内容。
+     */
+    virtual void bindWidget(int index, Widget& row) { (void)index; (void)row; }
+
+    /**
+     * @brief 第 index 项被点击 (List::click)
+     * 数据源在此修改自身的状态，List 随后重新绑定可见行。
+     */
+    virtual void clickAt(int index) { (void)index; }
+};
+
+/**
+ * @brief 虚拟化列表的默认行控件
+ * 文本复制到行内的定长缓冲区 (过长时截断)，绑定新的一项不分配内存。
+ */
+class ListRow : public Widget {
+public:
+    static const int TEXT_CAPACITY = 48; ///< 文本缓冲区字节数 (含 '\0')
+
+private:
+    char text[TEXT_CAPACITY];
+
+public:
+    ListRow() : Widget(0, 0, 0, 0) { text[0] = '\0'; }
+
+    /**
+     * @brief 设置显示文本
+     * 只在 List 绑定行时调用，重绘由 List 负责 (滚动或 reloadData 时整个列表都会重绘)。
+     */
+    void setText(const char* s);
+
+    void draw(Graphics& g) override;
+    const char* getText() const override { return text; }
+};
+
 /**
  * @brief 垂直滚动列表控件
  *
@@ -16,21 +105,135 @@ namespace Hydrogen {
  * - 选中框位置与宽度自适应动画
  * - 自动渲染裁剪（仅绘制可见区域）
  * - 内置滚动条
+ * - 虚拟化模式 (setDataSource)：数据来自 ListDataSource，只为可见行保留少量可复用的行控件
+ * - 行高可以不同 (ListLayout)：列表项控件的高度 (为 0 时取默认行高) 或 ListDataSource::heightAt()
+ * - 快速导航：可交互行索引 (next/prev 为 O(log n))、分组标题跳转、按前缀增量过滤
+ *
+ * 过滤模式下列表只显示匹配的项 (视图)，内部的行号均指视图中的行，
+ * 对外的列表项索引 (getSelectedIndex、setRowHeight 等) 始终指原始列表项。
+ *
+ * 行偏移、滚动位置与选中框位置都以整数像素保存，补间只推进相对目标的偏移，
+ * 定点数模式 (HYDROGEN_FIXED_POINT) 下列表总高度同样不受 Q16.16 整数范围的限制。
  */
 class List : public Widget {
 private:
     std::vector<Widget*> items;     ///< 列表项控件
+    ListDataSource* source;         ///< 虚拟化模式的数据源 (nullptr 表示使用 items)
+    std::vector<Widget*> rows;      ///< 虚拟化模式下复用的行控件，第 i 项使用 rows[i % rows.size()]
+    std::vector<int> rowIndex;      ///< 每个行控件当前绑定的列表项 (-1 表示未绑定)
+    bool customRows;                ///< 行控件由数据源的 createRow() 创建
+    WidgetArena* arena;             ///< 自动创建的列表项与行控件使用的内存池 (nullptr 时取 App 的设置)
+    ListLayout layout;              ///< 视图中各行的高度与偏移
+
+    // 导航索引 (均为升序)
+    std::vector<int> interactiveRows; ///< 可交互的行 (视图行号)，allInteractive 时为空
+    bool allInteractive;              ///< 视图中的行全部可交互
+    std::vector<int> sectionItems;    ///< 分组标题 (列表项索引)
+
+    // 过滤
+    static const int FILTER_CAPACITY = 24;
+    char filter[FILTER_CAPACITY];     ///< 当前过滤前缀，空串表示不过滤
+    std::vector<int> filtered;        ///< 过滤模式下视图第 i 行对应的列表项
     int selectedIndex;              ///< 当前选中的索引
-    int itemHeight;                 ///< 单行高度（像素）
+    int itemHeight;                 ///< 默认行高（像素）
     
     // 动画状态变量
-    float selectY;           ///< 选中框当前 Y 坐标
-    float targetSelectY;     ///< 选中框目标 Y 坐标
+    int targetSelectY;        ///< 选中框目标 Y 坐标
+    Scalar selectOffsetY;     ///< 选中框当前 Y 坐标相对目标的偏移 (动画中趋向 0)
     
-    float selectWidth;       ///< 选中框当前宽度
-    float targetSelectWidth; ///< 选中框目标宽度
+    Scalar selectWidth;       ///< 选中框当前宽度
+    Scalar targetSelectWidth; ///< 选中框目标宽度
+
+    Scalar selectHeight;       ///< 选中框当前高度
+    Scalar targetSelectHeight; ///< 选中框目标高度 (选中行的行高)
     
-    float easing;            ///< 动画缓动系数 (0.0 - 1.0)
+    uint16_t duration;        ///< 选中框动画时长 (毫秒)
+    Rect shownBox;            ///< 最近一次上报重绘的选中框
+    int measuredIndex;        ///< measuredWidth 对应的列表项 (-1 表示无)
+    int measuredWidth;        ///< 该项文本的宽度
+
+    /**
+     * @brief 当前选中框的区域 (世界坐标)
+     */
+    Rect selectionBox() const;
+
+    /**
+     * @brief 选中框补间的 onChange 回调：选中框变化时重绘新旧两个位置
+     */
+    static void selectionMoved(void* list);
+
+    /**
+     * @brief 视图行号对应的列表项索引
+     */
+    int toItem(int row) const { return filter[0] ? filtered[row] : row; }
+
+    /**
+     * @brief 列表项索引对应的视图行号，不在视图中时返回 -1
+     */
+    int toRow(int item) const;
+
+    /**
+     * @brief 第 item 项能否被选中 (分组标题不可选中)
+     */
+    bool isItemInteractive(int item) const;
+    bool isItemSection(int item) const;
+    const char* itemText(int item) const;
+    int itemHeightOf(int item) const;
+
+    /**
+     * @brief 视图第 row 行能否被选中 (O(log n))
+     */
+    bool isRowInteractive(int row) const;
+
+    /**
+     * @brief 从 row 起 (含) 向下第一个可交互的行，没有时返回 -1
+     */
+    int firstInteractiveFrom(int row) const;
+
+    /**
+     * @brief 把列表项追加到视图末尾，更新布局与可交互行索引
+     */
+    void appendRow(int item);
+
+    /**
+     * @brief 把视图第 row 行 (列表项 item) 登记到可交互行索引 (行需按顺序登记)
+     */
+    void indexRow(int item, int row);
+
+    /**
+     * @brief 重建视图 (布局、导航索引、虚拟化行绑定)
+     */
+    void rebuildView();
+
+    /**
+     * @brief 选中视图第 row 行并重绘 (相机在下一次 update 时直接移向该行)
+     */
+    void selectRow(int row);
+
+    /**
+     * @brief 获取视图第 row 行的控件 (虚拟化模式下按需绑定复用的行控件)
+     */
+    Widget* itemAt(int row);
+
+    /**
+     * @brief 视图第 row 行内容的宽度 (用于选中框)
+     */
+    int contentWidth(int row);
+
+    /**
+     * @brief 自动创建的控件所用的内存池
+     */
+    WidgetArena* arenaFor() const { return arena ? arena : App.getArena(); }
+
+    /**
+     * @brief 释放虚拟化模式的行控件
+     */
+    void releaseRows();
+
+    /**
+     * @brief 按最矮的行补足虚拟化模式的行控件，保证可见行不会争用同一个控件
+     */
+    void ensureRows();
 
 public:
     /**
@@ -41,13 +244,19 @@ public:
      * @param h 高度
      */
     List(int x, int y, int w, int h) 
-        : Widget(x, y, w, h), selectedIndex(0), itemHeight(16), 
-          selectY(0), targetSelectY(0), 
-          selectWidth(0), targetSelectWidth(0),
-          easing(0.3f) {
+        : Widget(x, y, w, h), source(nullptr), customRows(false), arena(nullptr), allInteractive(true), selectedIndex(0), itemHeight(16),
+          targetSelectY(0), selectOffsetY(0),
+          selectWidth(0), targetSelectWidth(0), selectHeight(0), targetSelectHeight(0),
+          duration(200), shownBox{0, 0, 0, 0}, measuredIndex(-1), measuredWidth(0) {
+        layout.reset(0, itemHeight);
+        filter[0] = '\0';
     }
 
     ~List() {
+        App.getAnimator().cancel(&selectOffsetY);
+        App.getAnimator().cancel(&selectWidth);
+        App.getAnimator().cancel(&selectHeight);
+        releaseRows();
         for (auto item : items) {
             delete item;
         }
@@ -56,19 +265,76 @@ public:
     /**
      * @brief 添加列表项 (文本)
      * 内部会自动创建一个 Label 控件
-     * @param item 显示文本 (支持 UTF-8)
+     * @param item 显示文本 (支持 UTF-8)，传入 StaticText("...") 时只引用不复制
      */
-    void addItem(const std::string& item);
+    void addItem(const TextValue& item);
 
     /**
      * @brief 添加列表项 (自定义控件)
+     * 行高取控件的高度，高度为 0 (如自适应的 Label) 时使用默认行高。
      * @param widget 控件指针 (List 将接管其生命周期)
      */
     void addItem(Widget* widget);
 
+    /**
+     * @brief 添加分组标题 (不可选中)
+     * 标题按字母顺序排列时，jumpTo() 可按前缀直接定位到对应分组。
+     * @param title 标题文本
+     */
+    void addSection(const TextValue& title);
+
+    /**
+     * @brief 删除所有列表项 (重建菜单前调用)，选中项回到第一项
+     */
+    void clear();
+
+    /**
+     * @brief 设置 addItem(文本)/addSection 创建的 Label 与虚拟化模式的行控件所用的内存池
+     * @param a 内存池 (不接管其生命周期)，nullptr 表示跟随 Application::setArena()
+     */
+    void setArena(WidgetArena* a) { arena = a; }
+
+    /**
+     * @brief 切换到虚拟化模式
+     * 之后列表内容全部来自数据源，addItem() 添加的项不再显示。
+     * 按视口高度创建 (可见行数 + 2) 个行控件，滚动时复用。
+     * @param dataSource 数据源 (List 不接管其生命周期)，nullptr 表示退出虚拟化模式
+     */
+    void setDataSource(ListDataSource* dataSource);
+
+    /**
+     * @brief 数据源的内容、行数或行高变化后调用，重建布局并重新绑定所有可见行
+     * 非虚拟化模式下按各列表项控件当前的高度重建布局。
+     */
+    void reloadData();
+
+    /**
+     * @brief 数据源的内容变化但行数与行高不变时调用 (如开关状态、进度值)
+     * 只重新绑定可见行并重绘列表，不重建布局。
+     */
+    void refreshRows();
+
+    /**
+     * @brief 列表项总数 (过滤模式下为匹配的项数)
+     */
+    int getItemCount() const { return layout.getCount(); }
+
+    /**
+     * @brief 修改第 index 项的行高 (O(log n))
+     * 列表项控件的尺寸改变后调用，或用于虚拟化模式下单独调整某一行。
+     * 该项被过滤掉时不做任何事 (重建视图时会重新读取行高)。
+     */
+    void setRowHeight(int index, int height);
+    int getRowHeight(int index) const;
+
+    /**
+     * @brief 获取行布局 (行偏移、按偏移查行)
+     */
+    const ListLayout& getLayout() const { return layout; }
+
     /**
      * @brief 选中下一项
-     * 循环滚动：到达底部后自动回到顶部
+     * 循环滚动：到达底部后自动回到顶部。不可交互的行通过索引直接跳过 (O(log n))。
      */
     void next();
 
@@ -78,12 +344,46 @@ public:
      */
     void prev();
 
+    /**
+     * @brief 跳到下一个分组的第一个可交互项 (循环)
+     * 过滤模式下分组标题不在视图中，不做任何事。
+     */
+    void nextSection();
+
+    /**
+     * @brief 跳到当前分组的第一项；已在第一项时跳到上一个分组 (循环)
+     */
+    void prevSection();
+
+    /**
+     * @brief 按前缀跳转 (不区分 ASCII 大小写)
+     * 有分组标题时先在按字母排序的标题中二分查找所属分组，只在该分组内查找匹配项；
+     * 没有分组时从头逐项查找。
+     * @return 是否找到匹配项 (分组存在但组内无匹配时选中分组的第一项，返回 false)
+     */
+    bool jumpTo(const char* prefix);
+
+    /**
+     * @brief 设置过滤前缀，只显示文本以其开头的项 (不区分 ASCII 大小写，不含分组标题)
+     * 新前缀是当前前缀的延长 (继续输入) 时只在上一次的结果中筛选，不重新扫描整个列表。
+     * 选中项仍在结果中时保持选中，否则选中第一个可交互的结果。
+     * @param prefix 前缀 (最多 FILTER_CAPACITY - 1 字节)，nullptr 或空串表示取消过滤
+     */
+    void setFilter(const char* prefix);
+    const char* getFilter() const { return filter; }
+    bool isFiltering() const { return filter[0] != '\0'; }
+
     /**
      * @brief 更新逻辑
      * 处理平滑滚动、相机跟随和选中框动画
      */
     void update() override;
 
+    /**
+     * @brief 选中框或任一列表项仍在动画中
+     */
+    bool isAnimating() const override;
+
     /**
      * @brief 绘制控件
      * @param g 图形上下文
@@ -91,14 +391,30 @@ public:
     void draw(Graphics& g) override;
 
     /**
-     * @brief 获取当前选中项的索引
+     * @brief 点击当前选中的列表项控件 (虚拟化模式下交给 ListDataSource::clickAt)
      */
-    int getSelectedIndex() const { return selectedIndex; }
+    void click() override;
+
+    /**
+     * @brief 编码器旋转选中下一项/上一项，按键按下点击选中项
+     */
+    bool handleEvent(const InputEvent& e) override;
+
+    /**
+     * @brief 获取当前选中项的索引 (原始列表项索引，不受过滤影响)
+     */
+    int getSelectedIndex() const { return getItemCount() > 0 ? toItem(selectedIndex) : 0; }
 
     /**
      * @brief 获取当前选中项的文本
      */
     std::string getSelectedItem() const;
+
+    /**
+     * @brief 设置选中框动画时长
+     * @param ms 时长 (毫秒)
+     */
+    void setDuration(uint16_t ms) { duration = ms; }
 };
 
 } // namespace Hydrogen
@@ -0,0 +1,104 @@
+#include "list_layout.h"
+#include <algorithm>
+
+namespace Hydrogen {
+
+int ListLayout::prefix(int n) const {
+    int sum = 0;
+    for (; n > 0; n -= n & -n) sum += tree[n];
+    return sum;
+}
+
+void ListLayout::buildTree() {
+    tree.assign(count + 1, 0);
+    for (int i = 1; i <= count; ++i) {
+        tree[i] += offsets ? offsets[i] - offsets[i - 1] : uniformHeight;
+        int parent = i + (i & -i);
+        if (parent <= count) tree[parent] += tree[i];
+    }
+    offsets = nullptr;
+}
+
+void ListLayout::reset(int n, int height) {
+    count = n;
+    uniformHeight = height;
+    minHeight = height;
+    tree.clear();
+    offsets = nullptr;
+}
+
+void ListLayout::setOffsets(const uint16_t* table, int n) {
+    count = n;
+    offsets = table;
+    tree.clear();
+    minHeight = n > 0 ? table[1] - table[0] : uniformHeight;
+    for (int i = 1; i < n; ++i) {
+        int h = table[i + 1] - table[i];
+        if (h < minHeight) minHeight = h;
+    }
+}
+
+void ListLayout::append(int height) {
+    if (tree.empty() && !offsets && (height == uniformHeight || count == 0)) {
+        if (count == 0) uniformHeight = minHeight = height;
+        count++;
+        return;
+    }
+    if (tree.empty()) buildTree();
+
+    // 新节点覆盖 (i - lowbit(i), i]，其中除新行外的部分是已有行的区间和
+    int i = ++count;
+    tree.push_back(height + prefix(i - 1) - prefix(i - (i & -i)));
+    if (height < minHeight) minHeight = height;
+}
+
+void ListLayout::setHeight(int index, int height) {
+    if (index < 0 || index >= count) return;
+    if (tree.empty()) {
+        if (!offsets && height == uniformHeight) return;
+        buildTree();
+    }
+    int delta = height - heightOf(index);
+    for (int i = index + 1; i <= count; i += i & -i) tree[i] += delta;
+    if (height < minHeight) minHeight = height;
+}
+
+int ListLayout::heightOf(int index) const {
+    if (offsets) return offsets[index + 1] - offsets[index];
+    if (tree.empty()) return uniformHeight;
+    return prefix(index + 1) - prefix(index);
+}
+
+int ListLayout::offsetOf(int index) const {
+    if (index <= 0) return 0;
+    if (index > count) index = count;
+    if (offsets) return offsets[index];
+    if (tree.empty()) return index * uniformHeight;
+    return prefix(index);
+}
+
+int ListLayout::indexAt(int offset) const {
+    if (count == 0 || offset < 0) return 0;
+
+    int index;
+    if (offsets) {
+        // 最后一个偏移不超过 offset 的行
+        index = (int)(std::upper_bound(offsets + 1, offsets + count + 1, offset) - offsets) - 1;
+    } else if (tree.empty()) {
+        index = uniformHeight > 0 ? offset / uniformHeight : 0;
+    } else {
+        // 二进制提升：找到前缀和不超过 offset 的最多行数
+        int step = 1;
+        while (step * 2 <= count) step *= 2;
+        index = 0;
+        for (; step > 0; step >>= 1) {
+            if (index + step <= count && tree[index + step] <= offset) {
+                index += step;
+                offset -= tree[index];
+            }
+        }
+    }
+    return index < count ? index : count - 1;
+}
+
+} // namespace Hydrogen
@@ -0,0 +1,88 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+namespace Hydrogen {
+
+/**
+ * @brief 列表的行布局 (每行高度与其前缀和)
+ *
+ * 所有行等高时只记录行数和行高，各项查询都是 O(1)；
+ * 一旦有行的高度不同，就建立一棵树状数组 (Fenwick tree)，
+ * 行偏移、按偏移查行、修改行高、追加行都是 O(log n)。
+ *
+ * 行高在编译期就确定的列表 (StaticMenu) 可以直接使用预先算好的偏移表 (setOffsets)，
+ * 不占用 RAM；之后修改行高或追加行时才复制为树状数组。
+ */
+class ListLayout {
+    int count;                   ///< 行数
+    int uniformHeight;           ///< 等高模式下的行高 (树状数组为空时有效)
+    int minHeight;               ///< 最矮的行高 (用于估算可见行数)
+    std::vector<int32_t> tree;   ///< 树状数组，tree[i] 为 (i - lowbit(i), i] 区间的行高之和 (下标从 1 开始)
+    const uint16_t* offsets;     ///< 外部的只读偏移表 (count + 1 项)，nullptr 表示未使用
+
+    /**
+     * @brief 前 n 行的高度之和
+     */
+    int prefix(int n) const;
+
+    /**
+     * @brief 把等高布局或偏移表展开为树状数组 (O(n)，只在第一次出现不同行高时发生)
+     */
+    void buildTree();
+
+public:
+    ListLayout() : count(0), uniformHeight(16), minHeight(16), offsets(nullptr) {}
+
+    /**
+     * @brief 重置为 count 行等高的布局
+     */
+    void reset(int count, int height);
+
+    /**
+     * @brief 使用预先算好的偏移表
+     * @param table 第 i 项为前 i 行的高度之和 (共 count + 1 项，可以位于 Flash)，需在布局使用期间有效
+     */
+    void setOffsets(const uint16_t* table, int count);
+
+    /**
+     * @brief 在末尾追加一行
+     */
+    void append(int height);
+
+    /**
+     * @brief 修改第 index 行的高度
+     */
+    void setHeight(int index, int height);
+
+    /**
+     * @brief 第 index 行的高度
+     */
+    int heightOf(int index) const;
+
+    /**
+     * @brief 第 index 行顶边相对第 0 行顶边的偏移 (即前 index 行的高度之和)
+     */
+    int offsetOf(int index) const;
+
+    /**
+     * @brief 包含纵向偏移 offset 的行
+     * 偏移在第 0 行之前时返回 0，超出末尾时返回最后一行。
+     */
+    int indexAt(int offset) const;
+
+    /**
+     * @brief 所有行的总高度
+     */
+    int totalHeight() const { return offsetOf(count); }
+
+    int getCount() const { return count; }
+    int getMinHeight() const { return minHeight; }
+
+    /**
+     * @brief 是否处于等高的 O(1) 模式
+     */
+    bool isUniform() const { return tree.empty() && !offsets; }
+};
+
+} // namespace Hydrogen
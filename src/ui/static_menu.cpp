@@ -0,0 +1,62 @@
+#include "static_menu.h"
+
+namespace Hydrogen {
+
+void StaticMenuRow::bind(const MenuEntry& e, uint8_t v) {
+    entry = &e;
+    value = v;
+    bool textOnly = e.kind != MenuEntry::Kind::Switch && e.kind != MenuEntry::Kind::Progress;
+    bounds.w = textOnly ? 0 : width;
+    bounds.h = e.height;
+}
+
+void StaticMenuRow::draw(Graphics& g) {
+    if (!visible || !entry) return;
+
+    switch (entry->kind) {
+    case MenuEntry::Kind::Item:
+    case MenuEntry::Kind::Section:
+        g.drawText(bounds.x, bounds.y, entry->text); // List 把 y 设为基线
+        break;
+
+    case MenuEntry::Kind::Submenu: {
+        // 与自适应宽度的 Label 相同：箭头画在文本右侧
+        g.drawText(bounds.x, bounds.y, entry->text);
+        int arrowX = bounds.x + g.getTextWidth(entry->text) + 10;
+        int arrowY = bounds.y - 4;
+        g.drawLine(arrowX, arrowY, arrowX + 4, arrowY + 4);
+        g.drawLine(arrowX, arrowY + 8, arrowX + 4, arrowY + 4);
+        break;
+    }
+
+    case MenuEntry::Kind::Switch: {
+        // 外形与 Switch 相同 (13x25 的胶囊，9px 滑块)，状态切换没有动画
+        g.drawText(bounds.x + 2, bounds.y + bounds.h/2 + 4, entry->text);
+        int swX = bounds.x + bounds.w - 25 - 4;
+        int swY = bounds.y + (bounds.h - 13) / 2;
+        g.drawRoundRect(swX, swY, 25, 13, 6);
+        if (value) {
+            g.fillCircle(swX + 25 - 9 - 2 + 4, swY + 2 + 4, 4);
+        } else {
+            g.drawCircle(swX + 2 + 4, swY + 2 + 4, 4);
+        }
+        break;
+    }
+
+    case MenuEntry::Kind::Progress: {
+        // 与单行模式的 ProgressBar 相同
+        g.drawText(bounds.x + 2, bounds.y + bounds.h/2 + 4, entry->text);
+        int barW = bounds.w - g.getTextWidth(entry->text) - 12;
+        if (barW < 20) barW = 20;
+        int barH = 8;
+        int barX = bounds.x + bounds.w - barW - 4;
+        int barY = bounds.y + (bounds.h - barH) / 2;
+        g.drawRect(barX, barY, barW, barH);
+        int fillW = (barW - 4) * value / 255;
+        if (fillW > 0) g.fillRect(barX + 2, barY + 2, fillW, barH - 4);
+        break;
+    }
+    }
+}
+
+} // namespace Hydrogen
@@ -0,0 +1,241 @@
+#pragma once
+#include "list.h"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Hydrogen {
+
+/**
+ * @brief 静态菜单的一项 (字面量类型，定义为 constexpr 数组后位于 Flash/rodata)
+ */
+struct MenuEntry {
+    enum class Kind : uint8_t {
+        Item,     ///< 普通菜单项 (可选中)
+        Submenu,  ///< 带二级菜单箭头的菜单项 (可选中)
+        Section,  ///< 分组标题 (不可选中)
+        Switch,   ///< 开关 (可选中，点击切换)
+        Progress  ///< 进度条 (只读)
+    };
+
+    Kind kind;
+    uint8_t height;    ///< 行高 (像素)
+    uint8_t initial;   ///< 初始状态：开关为 0/1，进度条为 0 ~ 255
+    const char* text;  ///< 显示文本 (字符串常量)
+
+    /**
+     * @brief 是否需要在 RAM 中保存状态
+     */
+    constexpr bool hasState() const { return kind == Kind::Switch || kind == Kind::Progress; }
+};
+
+constexpr MenuEntry menuItem(const char* text, uint8_t height = 16) {
+    return MenuEntry{MenuEntry::Kind::Item, height, 0, text};
+}
+
+constexpr MenuEntry menuSubmenu(const char* text, uint8_t height = 16) {
+    return MenuEntry{MenuEntry::Kind::Submenu, height, 0, text};
+}
+
+constexpr MenuEntry menuSection(const char* text, uint8_t height = 16) {
+    return MenuEntry{MenuEntry::Kind::Section, height, 0, text};
+}
+
+constexpr MenuEntry menuSwitch(const char* text, bool initial = false, uint8_t height = 16) {
+    return MenuEntry{MenuEntry::Kind::Switch, height, (uint8_t)(initial ? 1 : 0), text};
+}
+
+/**
+ * @param initial 初始进度 (0.0 ~ 1.0)
+ */
+constexpr MenuEntry menuProgress(const char* text, float initial = 0.0f, uint8_t height = 16) {
+    return MenuEntry{MenuEntry::Kind::Progress, height,
+                     (uint8_t)(initial <= 0.0f ? 0 : initial >= 1.0f ? 255 : initial * 255 + 0.5f), text};
+}
+
+/**
+ * @brief 前 i 项的行高之和
+ */
+constexpr size_t menuOffset(const MenuEntry* entries, size_t i) {
+    return i == 0 ? 0 : menuOffset(entries, i - 1) + entries[i - 1].height;
+}
+
+/**
+ * @brief 前 i 项中有状态 (开关、进度条) 的项数，即第 i 项的状态槽位
+ */
+constexpr size_t menuSlot(const MenuEntry* entries, size_t i) {
+    return i == 0 ? 0 : menuSlot(entries, i - 1) + (entries[i - 1].hasState() ? 1 : 0);
+}
+
+/// 编译期下标序列 (C++11 没有 std::index_sequence)
+template <size_t... I> struct MenuIndices {};
+template <size_t N, size_t... I> struct MakeMenuIndices : MakeMenuIndices<N - 1, N - 1, I...> {};
+template <size_t... I> struct MakeMenuIndices<0, I...> { typedef MenuIndices<I...> Type; };
+
+/**
+ * @brief 在编译期由菜单项数组展开的查找表 (只读)
+ */
+template <size_t N, const MenuEntry (&ENTRIES)[N], class Indices = typename MakeMenuIndices<N + 1>::Type>
+struct MenuTables;
+
+template <size_t N, const MenuEntry (&ENTRIES)[N], size_t... I>
+struct MenuTables<N, ENTRIES, MenuIndices<I...> > {
+    static constexpr uint16_t offsets[N + 1] = {(uint16_t)menuOffset(ENTRIES, I)...}; ///< 行偏移
+    static constexpr uint8_t slots[N + 1] = {(uint8_t)menuSlot(ENTRIES, I)...};      ///< 状态槽位
+};
+
+template <size_t N, const MenuEntry (&ENTRIES)[N], size_t... I>
+constexpr uint16_t MenuTables<N, ENTRIES, MenuIndices<I...> >::offsets[N + 1];
+
+template <size_t N, const MenuEntry (&ENTRIES)[N], size_t... I>
+constexpr uint8_t MenuTables<N, ENTRIES, MenuIndices<I...> >::slots[N + 1];
+
+/**
+ * @brief 静态菜单的行控件
+ * 只引用 Flash 中的菜单项，按类型绘制文本、二级菜单箭头、开关或进度条。
+ */
+class StaticMenuRow : public Widget {
+    const MenuEntry* entry;
+    uint8_t value;
+    int16_t width; ///< 开关、进度条行的宽度
+
+public:
+    explicit StaticMenuRow(int width) : Widget(0, 0, 0, 0), entry(nullptr), value(0), width((int16_t)width) {}
+
+    /**
+     * @brief 绑定到菜单项 (只在 List 绑定行时调用)
+     * 文本类的行宽度为 0，由 List 按基线对齐并测量文本宽度；开关与进度条按行宽、顶边对齐。
+     */
+    void bind(const MenuEntry& e, uint8_t value);
+
+    void draw(Graphics& g) override;
+    const char* getText() const override { return entry ? entry->text : ""; }
+};
+
+/**
+ * @brief 编译期确定的静态菜单 (List 的数据源)
+ *
+ * 菜单项的文本、类型、行高以及由此算出的行偏移表全部在编译期确定并位于 Flash，
+ * RAM 中只保存开关状态和进度值 (每项 1 字节)；List 以虚拟化模式显示，
+ * 只为可见行创建少量行控件，启动时不为每一项 new 控件、复制字符串或计算布局。
+ *
+ * 状态由程序修改后 (setState/setValue) 调用 List::refreshRows() 重绘。
+ * 开关在行控件复用时直接显示新状态，没有 Switch 控件的滑块动画。
+ *
+ * @code
+ *   static constexpr MenuEntry SETTINGS[] = {
+ *       menuSection("Network"),
+ *       menuSwitch("Wi-Fi", true),
+ *       menuSubmenu("Networks"),
+ *       menuSection("Display"),
+ *       menuProgress("Brightness", 0.8f),
+ *   };
+ *   static HYDROGEN_STATIC_MENU(SETTINGS) settings;
+ *
+ *   List* list = new List(0, 0, 128, 64);
+ *   list->setDataSource(&settings);
+ *   App.add(list);
+ * @endcode
+ */
+template <size_t N, const MenuEntry (&ENTRIES)[N]>
+class StaticMenu : public ListDataSource {
+public:
+    typedef MenuTables<N, ENTRIES> Tables;
+
+    /// 需要保存状态的项数
+    static const size_t STATE_COUNT = menuSlot(ENTRIES, N);
+
+    /**
+     * @brief 点击菜单项的回调 (开关在回调前已切换)
+     */
+    typedef void (*ClickHandler)(int index, void* user);
+
+private:
+    static_assert(N > 0, "static menu must not be empty");
+    static_assert(menuOffset(ENTRIES, N) <= 0xFFFF, "static menu is taller than 65535 px");
+    static_assert(STATE_COUNT <= 0xFF, "static menu has too many switches/progress bars");
+
+    uint8_t values[STATE_COUNT > 0 ? STATE_COUNT : 1];
+    int16_t rowWidth;
+    ClickHandler handler;
+    void* handlerUser;
+
+    uint8_t& valueOf(int index) { return values[Tables::slots[index]]; }
+    uint8_t valueOf(int index) const { return values[Tables::slots[index]]; }
+
+public:
+    /**
+     * @param rowWidth 开关与进度条行的宽度
+     */
+    explicit StaticMenu(int rowWidth = 120) : rowWidth((int16_t)rowWidth), handler(nullptr), handlerUser(nullptr) {
+        for (size_t i = 0; i < N; ++i) {
+            if (ENTRIES[i].hasState()) values[Tables::slots[i]] = ENTRIES[i].initial;
+        }
+    }
+
+    /**
+     * @brief 设置点击回调
+     */
+    void setClickHandler(ClickHandler h, void* user = nullptr) {
+        handler = h;
+        handlerUser = user;
+    }
+
+    static const MenuEntry& entry(int index) { return ENTRIES[index]; }
+
+    /**
+     * @brief 开关状态 (其他类型的项返回 false)
+     */
+    bool getState(int index) const {
+        return ENTRIES[index].kind == MenuEntry::Kind::Switch && valueOf(index) != 0;
+    }
+
+    void setState(int index, bool on) {
+        if (ENTRIES[index].kind == MenuEntry::Kind::Switch) valueOf(index) = on ? 1 : 0;
+    }
+
+    /**
+     * @brief 进度值 (0.0 ~ 1.0，其他类型的项返回 0)
+     */
+    float getValue(int index) const {
+        return ENTRIES[index].kind == MenuEntry::Kind::Progress ? valueOf(index) / 255.0f : 0.0f;
+    }
+
+    void setValue(int index, float v) {
+        if (ENTRIES[index].kind != MenuEntry::Kind::Progress) return;
+        if (v < 0.0f) v = 0.0f;
+        if (v > 1.0f) v = 1.0f;
+        valueOf(index) = (uint8_t)(v * 255 + 0.5f);
+    }
+
+    int count() const override { return (int)N; }
+    const char* textAt(int index) const override { return ENTRIES[index].text; }
+    int heightAt(int index) const override { return ENTRIES[index].height; }
+    const uint16_t* rowOffsets() const override { return Tables::offsets; }
+
+    bool isInteractive(int index) const override {
+        MenuEntry::Kind k = ENTRIES[index].kind;
+        return k != MenuEntry::Kind::Section && k != MenuEntry::Kind::Progress;
+    }
+
+    bool isSection(int index) const override { return ENTRIES[index].kind == MenuEntry::Kind::Section; }
+
+    Widget* createRow() override { return makeWidget<StaticMenuRow>(App.getArena(), rowWidth); }
+
+    void bindWidget(int index, Widget& row) override {
+        static_cast<StaticMenuRow&>(row).bind(ENTRIES[index], ENTRIES[index].hasState() ? valueOf(index) : 0);
+    }
+
+    void clickAt(int index) override {
+        if (!isInteractive(index)) return;
+        if (ENTRIES[index].kind == MenuEntry::Kind::Switch) valueOf(index) ^= 1;
+        if (handler) handler(index, handlerUser);
+    }
+};
+
+/**
+ * @brief 由 constexpr 菜单项数组得到静态菜单类型
+ */
+#define HYDROGEN_STATIC_MENU(entries) \
+    ::Hydrogen::StaticMenu<sizeof(entries) / sizeof((entries)[0]), entries>
+
+} // namespace Hydrogen
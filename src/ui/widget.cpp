@@ -1,4 +1,7 @@
 #include "widget.h"
+#include "../core/app.h"
+#include <stdio.h>
+#include <string.h>
 
 namespace Hydrogen {
 
@@ -8,9 +11,43 @@ Widget::~Widget() {
     }
 }
 
+void* Widget::operator new(size_t size) {
+    return ::operator new(size);
+}
+
+void Widget::operator delete(void* p) {
+    if (!WidgetArena::release(p)) ::operator delete(p);
+}
+
+void Widget::invalidate() {
+    if (bounds.isEmpty()) {
+        App.invalidateAll();
+    } else {
+        App.invalidate(getWorldBounds());
+    }
+}
+
+void Widget::invalidate(const Rect& area) {
+    App.invalidate(Rect{area.x + worldX - bounds.x, area.y + worldY - bounds.y, area.w, area.h});
+}
+
+void Widget::updateWorldOrigin() {
+    worldX = bounds.x;
+    worldY = bounds.y;
+    if (parent) {
+        worldX += parent->worldX;
+        worldY += parent->worldY;
+    }
+    for (auto child : children) {
+        child->updateWorldOrigin();
+    }
+}
+
 void Widget::addChild(Widget* child) {
     child->parent = this;
     children.push_back(child);
+    child->updateWorldOrigin();
+    child->invalidate();
 }
 
 void Label::draw(Graphics& g) {
@@ -35,7 +72,7 @@ void Label::draw(Graphics& g) {
         // 让我们用简单的偏移
     }
 
-    g.drawText(bounds.x, drawY, text);
+    g.drawText(bounds.x, drawY, text.c_str());
 
     // 绘制二级菜单箭头 (->)
     if (hasArrow) {
@@ -48,7 +85,7 @@ void Label::draw(Graphics& g) {
             arrowX = bounds.x + bounds.w - 10;
         } else {
             // 自适应模式：画在文本右侧
-            int textW = g.getHAL()->getStrWidth(text.c_str());
+            int textW = g.getTextWidth(text.c_str());
             arrowX = bounds.x + textW + 10;
         }
 
@@ -61,28 +98,25 @@ void Label::draw(Graphics& g) {
 }
 
 void Switch::toggle() {
-    isOn = !isOn;
-    targetKnobX = isOn ? 1.0f : 0.0f;
+    setState(!isOn);
 }
 
-void Switch::setState(bool s) {
-    isOn = s;
-    targetKnobX = isOn ? 1.0f : 0.0f;
+Switch::~Switch() {
+    App.getAnimator().cancel(&knobX);
 }
 
-void Switch::update() {
-    if (std::abs(targetKnobX - knobX) > 0.05f) {
-        knobX += (targetKnobX - knobX) * 0.3f;
-    } else {
-        knobX = targetKnobX;
-    }
+void Switch::setState(bool s) {
+    if (isOn != s) invalidate(); // 滑块的实心/空心状态立即改变
+    isOn = s;
+    targetKnobX = isOn ? 1 : 0;
+    App.getAnimator().animate(&knobX, targetKnobX, duration, Curve::EaseInOut, invalidateCallback, this);
 }
 
 void Switch::draw(Graphics& g) {
     if (!visible) return;
 
     // 1. 绘制左侧描述文本 (垂直居中)
-    g.drawText(bounds.x + 2, bounds.y + bounds.h/2 + 4, label);
+    g.drawText(bounds.x + 2, bounds.y + bounds.h/2 + 4, label.c_str());
 
     // 2. 绘制右侧开关图标
     // 为了让圆形的滑块(直径总是奇数)能完美垂直居中，外框高度最好也是奇数
@@ -107,7 +141,7 @@ void Switch::draw(Graphics& g) {
     int minKnobX = swX + margin;
     int maxKnobX = swX + swW - knobDiameter - margin;
 
-    int knobXPos = minKnobX + (int)((maxKnobX - minKnobX) * knobX);
+    int knobXPos = minKnobX + scalarToInt(Scalar(maxKnobX - minKnobX) * knobX);
     int knobY = swY + margin; // y偏移
 
     // 计算圆心
@@ -120,7 +154,7 @@ void Switch::draw(Graphics& g) {
     int centerX = knobXPos + r;
     int centerY = knobY + r;
 
-    if (isOn || knobX > 0.5f) {
+    if (isOn || knobX * 2 > Scalar(1)) {
         // 实心圆滑块表示开启
         g.fillCircle(centerX, centerY, r);
     } else {
@@ -129,16 +163,24 @@ void Switch::draw(Graphics& g) {
     }
 }
 
-void ProgressBar::update() {
-    // 一阶低通滤波 (Exponential Moving Average)
-    // value = (target * alpha) + (current * (1 - alpha))
-    // 这里的 smoothing 参数直接作为 alpha
-    //
-    // 如果差异很小，直接等于目标值，避免浮点数“无限逼近”导致的计算开销
-    if (std::abs(targetValue - value) > 0.001f) {
-        value += (targetValue - value) * smoothing;
+ProgressBar::~ProgressBar() {
+    App.getAnimator().cancel(&value);
+}
+
+void ProgressBar::setValue(float v) {
+    if (v < 0.0f) v = 0.0f;
+    if (v > 1.0f) v = 1.0f;
+    targetValue = v; // 仅设置目标值，显示值由补间平滑过渡
+    App.getAnimator().animate(&value, targetValue, duration, Curve::EaseOut, invalidateCallback, this);
+}
+
+void ProgressBar::setSmoothing(float s) {
+    // 指数平滑每步走完 s 的剩余距离，约 3 / s 步后走完 95%
+    if (s >= 1.0f) {
+        duration = 0;
     } else {
-        value = targetValue;
+        float ms = s > 0.0f ? HYDROGEN_TICK_MS * 3 / s : 65535.0f;
+        duration = ms > 65535.0f ? 65535 : (uint16_t)ms;
     }
 }
 
@@ -148,7 +190,7 @@ void ProgressBar::draw(Graphics& g) {
     if (twoLineMode) {
         // 两行模式
         // 第一行：文本
-        g.drawText(bounds.x + 2, bounds.y + bounds.h/4 + 4, label);
+        g.drawText(bounds.x + 2, bounds.y + bounds.h/4 + 4, label.c_str());
 
         // 第二行：进度条 (占满宽度)
         int barW = bounds.w - 4;
@@ -158,8 +200,8 @@ void ProgressBar::draw(Graphics& g) {
 
         g.drawRect(barX, barY, barW, barH);
 
-        if (value > 0.0f) {
-            int fillW = (int)((barW - 4) * value);
+        if (value > Scalar(0)) {
+            int fillW = scalarToInt(Scalar(barW - 4) * value);
             if (fillW > 0) {
                 g.fillRect(barX + 2, barY + 2, fillW, barH - 4);
             }
@@ -167,10 +209,10 @@ void ProgressBar::draw(Graphics& g) {
     } else {
         // 单行模式 (原有逻辑)
         // 1. 绘制左侧描述文本
-        g.drawText(bounds.x + 2, bounds.y + bounds.h/2 + 4, label);
+        g.drawText(bounds.x + 2, bounds.y + bounds.h/2 + 4, label.c_str());
 
         // 2. 智能计算进度条宽度
-        int textW = g.getHAL()->getStrWidth(label.c_str());
+        int textW = g.getTextWidth(label.c_str());
         int maxBarW = bounds.w - textW - 12;
         if (maxBarW < 20) maxBarW = 20;
 
@@ -181,8 +223,8 @@ void ProgressBar::draw(Graphics& g) {
 
         g.drawRect(barX, barY, barW, barH);
 
-        if (value > 0.0f) {
-            int fillW = (int)((barW - 4) * value);
+        if (value > Scalar(0)) {
+            int fillW = scalarToInt(Scalar(barW - 4) * value);
             if (fillW > 0) {
                 g.fillRect(barX + 2, barY + 2, fillW, barH - 4);
             }
@@ -220,6 +262,10 @@ void CircleWidget::draw(Graphics& g) {
     }
 }
 
+void Panel::draw(Graphics& g) {
+    if (border) g.drawRect(bounds.x, bounds.y, bounds.w, bounds.h);
+}
+
 void Pixel::draw(Graphics& g) {
     if (!visible) return;
     // Graphics 没有 drawPixel，用 1px 线代替，或者调用 HAL
@@ -227,12 +273,117 @@ void Pixel::draw(Graphics& g) {
     g.drawLine(bounds.x, bounds.y, bounds.x, bounds.y);
 }
 
-void Logger::log(const std::string& msg) {
-    lines.push_back(msg);
-    // 保持最大行数
-    while ((int)lines.size() > maxLines) {
-        lines.erase(lines.begin());
+namespace {
+
+// 截断后的文本如果以不完整的 UTF-8 字符结尾，去掉这个字符
+size_t trimUtf8(const char* s, size_t n) {
+    size_t i = n;
+    while (i > 0 && ((uint8_t)s[i - 1] & 0xC0) == 0x80) --i;
+    if (i == 0) return n;
+    uint8_t lead = (uint8_t)s[i - 1];
+    size_t need = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+    return (i - 1 + need > n) ? i - 1 : n;
+}
+
+} // namespace
+
+Logger::Logger(int x, int y, int w, int h, int maxLines, size_t arenaSize)
+    : Widget(x, y, w, h), maxLines(maxLines > 0 ? maxLines : 1), lineHeight(12), autoScroll(true),
+      head(0), tail(0), written(0), cursor(0), seq(0), drawnSeq(0) {
+    if (arenaSize == 0) arenaSize = (size_t)this->maxLines * 32;
+    if (arenaSize > 0xFFFF) arenaSize = 0xFFFF; // 行偏移为 16 位
+    if (arenaSize < 2) arenaSize = 2;
+    arena.resize(arenaSize);
+    lines.resize(this->maxLines);
+}
+
+size_t Logger::place(size_t size) {
+    size_t start = cursor;
+    if (size > arena.size() - cursor) {
+        // 字符区末尾放不下，跳到开头 (跳过的部分也计入写入流)
+        written += (uint32_t)(arena.size() - cursor);
+        start = 0;
+    }
+    // 丢弃会被覆盖的旧行，并为新行空出一个槽位
+    uint32_t end = written + (uint32_t)size;
+    while (tail != head) {
+        const Line& l = lines[tail % maxLines];
+        if (head - tail < (uint32_t)maxLines && end - l.pos <= arena.size()) break;
+        ++tail;
     }
+    return start;
+}
+
+void Logger::commit(size_t start, size_t length) {
+    Line& l = lines[head % maxLines];
+    l.pos = written;
+    l.offset = (uint16_t)start;
+    l.length = (uint16_t)length;
+    written += (uint32_t)(length + 1);
+    cursor = start + length + 1;
+    ++head;
+}
+
+void Logger::beginWrite() {
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void Logger::endWrite() {
+    seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void Logger::log(const char* msg) {
+    if (!msg) msg = "";
+    size_t n = strlen(msg);
+    if (n > arena.size() - 1) n = trimUtf8(msg, arena.size() - 1);
+
+    beginWrite();
+    size_t start = place(n + 1);
+    memcpy(arena.data() + start, msg, n);
+    arena[start + n] = '\0';
+    commit(start, n);
+    endWrite();
+}
+
+void Logger::logf(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vlogf(fmt, args);
+    va_end(args);
+}
+
+void Logger::vlogf(const char* fmt, va_list args) {
+    va_list again;
+    va_copy(again, args);
+
+    beginWrite();
+    // 先尝试直接格式化到当前位置，放不下再换到字符区开头重新格式化
+    size_t before = cursor;
+    int n = vsnprintf(arena.data() + before, arena.size() - before, fmt, args);
+    size_t length = n > 0 ? (size_t)n : 0;
+    if (length > arena.size() - 1) length = arena.size() - 1;
+    size_t start = place(length + 1);
+    if (start != before) vsnprintf(arena.data() + start, length + 1, fmt, again);
+    if (n > 0 && (size_t)n > length) {
+        length = trimUtf8(arena.data() + start, length);
+        arena[start + length] = '\0';
+    }
+    commit(start, length);
+    endWrite();
+
+    va_end(again);
+}
+
+void Logger::clear() {
+    beginWrite();
+    tail = head;
+    endWrite();
+}
+
+void Logger::update() {
+    // 生产者不能直接调用 invalidate()，由 UI 这边发现新内容后再标记重绘
+    if (seq.load(std::memory_order_acquire) != drawnSeq) invalidate();
 }
 
 void Logger::draw(Graphics& g) {
@@ -241,28 +392,48 @@ void Logger::draw(Graphics& g) {
     // 绘制终端背景 (可选)
     // g.fillRect(bounds.x, bounds.y, bounds.w, bounds.h); // 需要设置颜色反转逻辑，这里默认黑色背景
 
+    // 生产者正在写入时放弃本帧，drawnSeq 不更新，下一次 update() 会再次标记重绘
+    uint32_t s = seq.load(std::memory_order_acquire);
+    if (s & 1) return;
+    uint32_t first = tail, last = head;
+    if (last - first > (uint32_t)maxLines) return;
+
     int y = bounds.y;
-    for (const auto& line : lines) {
-        g.drawText(bounds.x + 2, y + lineHeight, line); // 基线对齐
+    for (uint32_t i = first; i != last; ++i) {
+        // 先复制到栈上，确认复制期间没有被改写再绘制 (超出 64 字节的部分本来也在屏幕外)
+        Line l = lines[i % maxLines];
+        char text[64];
+        size_t n = l.offset < arena.size() ? arena.size() - l.offset : 0;
+        if (n > l.length) n = l.length;
+        if (n > sizeof(text)) n = trimUtf8(arena.data() + l.offset, sizeof(text));
+        memcpy(text, arena.data() + l.offset, n);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq.load(std::memory_order_relaxed) != s) return;
+
+        g.drawText(bounds.x + 2, y + lineHeight, text, n); // 基线对齐
         y += lineHeight;
     }
 
     // 绘制光标 (闪烁效果可加)
-    if (lines.size() < (size_t)maxLines) {
+    if (last - first < (uint32_t)maxLines) {
         g.drawText(bounds.x + 2, y + lineHeight, "_");
     }
+    drawnSeq = s;
 }
 
 MatrixRain::MatrixRain(int x, int y, int w, int h) : Widget(x, y, w, h) {
     for (int i = 0; i < MAX_COLS; i++) {
         cols[i].y = -std::rand() % 64; // 随机初始高度
-        cols[i].speed = (std::rand() % 20 + 10) / 10.0f; // 随机速度 1.0 ~ 3.0
+        cols[i].speed = Scalar(std::rand() % 20 + 10) * Scalar(0.1f); // 随机速度 1.0 ~ 3.0
         cols[i].length = std::rand() % 6 + 3; // 长度 3~8
         cols[i].content = (char)(std::rand() % 94 + 33); // ASCII 33-126
     }
 }
 
 void MatrixRain::update() {
+    // 每帧都在下落，整个区域持续失效
+    invalidate();
+
     for (int i = 0; i < MAX_COLS; i++) {
         cols[i].y += cols[i].speed;
 
@@ -271,9 +442,9 @@ void MatrixRain::update() {
             cols[i].content = (char)(std::rand() % 94 + 33);
         }
 
-        if (cols[i].y > bounds.h + 10) {
+        if (cols[i].y > Scalar(bounds.h + 10)) {
             cols[i].y = -(std::rand() % 20);
-            cols[i].speed = (std::rand() % 30 + 10) / 10.0f;
+            cols[i].speed = Scalar(std::rand() % 30 + 10) * Scalar(0.1f);
         }
     }
 }
@@ -284,7 +455,7 @@ void MatrixRain::draw(Graphics& g) {
     // 列宽 6px，行高 8px (对于小字体)
     for (int i = 0; i < MAX_COLS; i++) {
         int x = bounds.x + i * 6;
-        int headY = (int)cols[i].y;
+        int headY = scalarToInt(cols[i].y);
 
         // 绘制整条雨滴
         for (int j = 0; j < cols[i].length; j++) {
@@ -295,8 +466,7 @@ void MatrixRain::draw(Graphics& g) {
             if (y > bounds.h) continue; // 已经掉出屏幕
 
             // 字符生成：头部是 content，尾部依次偏移
-            char displayChar = (char)(((cols[i].content + j) % 94) + 33);
-            std::string s(1, displayChar);
+            char s[2] = {(char)(((cols[i].content + j) % 94) + 33), '\0'};
 
             // 绘制
             // 注意：头部(j=0)应该是最亮的。OLED 没有亮度，我们全画实心。
@@ -1,7 +1,14 @@
 #pragma once
 #include "../core/graphics.h"
+#include "../core/timing.h"
+#include "../core/animator.h"
+#include "../core/text.h"
+#include "../core/input.h"
+#include "../core/arena.h"
 #include <vector>
 #include <string>
+#include <atomic>
+#include <stdarg.h>
 
 namespace Hydrogen {
 
@@ -9,14 +16,23 @@ namespace Hydrogen {
  * @brief UI 控件基类
  *
  * 所有 UI 组件（如按钮、列表、标签）都必须继承此类。
- * 支持树状层级结构（父子关系），尽管目前主要使用扁平结构。
+ * 支持树状层级结构（父子关系）：子控件的坐标相对于父控件的左上角，
+ * Application 按树遍历更新与绘制，绘制子控件前通过 Graphics::translate() 平移原点，
+ * 因此 draw() 始终按自身的 bounds 绘制。控件不可见、或 (非根控件) 完全落在裁剪区外时
+ * 整棵子树被跳过，因此子控件应位于父控件的范围内。
  */
 class Widget {
 protected:
-    Rect bounds;                ///< 控件的几何边界 (x, y, w, h)
+    Rect bounds;                ///< 控件的几何边界 (x, y, w, h)，坐标相对于父控件 (根控件即世界坐标)
     Widget* parent;             ///< 父控件指针
     std::vector<Widget*> children; ///< 子控件列表
     bool visible;               ///< 可见性标志
+    int worldX, worldY;         ///< bounds 左上角的世界坐标 (缓存，控件或祖先移动时更新)
+
+    /**
+     * @brief 按父控件重新计算本控件及所有子孙的世界坐标
+     */
+    void updateWorldOrigin();
 
 public:
     /**
@@ -26,9 +42,17 @@ public:
      * @param w 宽度
      * @param h 高度
      */
-    Widget(int x, int y, int w, int h) : bounds({x, y, w, h}), parent(nullptr), visible(true) {}
+    Widget(int x, int y, int w, int h)
+        : bounds({x, y, w, h}), parent(nullptr), visible(true), worldX(x), worldY(y) {}
     virtual ~Widget();
 
+    /**
+     * @brief 分配/释放控件内存
+     * new 出来的控件仍使用堆；在 WidgetArena 中构造的控件 (Application::make) 释放时把内存还给内存池。
+     */
+    static void* operator new(size_t size);
+    static void operator delete(void* p);
+
     /**
      * @brief 绘制方法（纯虚函数）
      * 子类必须实现此方法来定义控件的外观。
@@ -38,20 +62,41 @@ public:
 
     /**
      * @brief 逻辑更新方法
-     * 每帧调用一次，用于处理动画、输入等非绘图逻辑。
+     * 每个逻辑步长 (HYDROGEN_TICK_MS) 调用一次，用于处理动画、输入等非绘图逻辑。
      */
     virtual void update() {}
 
+    /**
+     * @brief 控件是否仍在播放动画
+     * 用于判断界面是否静止 (参见 Application::isIdle)。
+     * 控件的绘制内容本身仍需通过 invalidate() 上报。
+     */
+    virtual bool isAnimating() const { return false; }
+
+    /**
+     * @brief 是否为纯装饰性控件
+     * 帧耗时持续超出预算时，Application 会暂停更新和绘制装饰性控件
+     * (参见 FrameGovernor)。
+     */
+    virtual bool isDecorative() const { return false; }
+
     /**
      * @brief 添加子控件
-     * @param child 子控件指针
+     * @param child 子控件指针 (父控件接管其生命周期)，坐标相对于本控件的左上角
      */
     void addChild(Widget* child);
 
+    Widget* getParent() const { return parent; }
+    const std::vector<Widget*>& getChildren() const { return children; }
+
     /**
      * @brief 设置可见性
      */
-    void setVisible(bool v) { visible = v; }
+    void setVisible(bool v) {
+        if (visible == v) return;
+        visible = v;
+        invalidate();
+    }
 
     /**
      * @brief 检查是否可见
@@ -59,18 +104,39 @@ public:
     bool isVisible() const { return visible; }
 
     /**
-     * @brief 获取控件边界
+     * @brief 获取控件边界 (相对于父控件)
      */
     Rect getBounds() const { return bounds; }
 
+    /**
+     * @brief 获取控件在世界坐标下的边界 (使用缓存的世界坐标，O(1))
+     */
+    Rect getWorldBounds() const { return Rect{worldX, worldY, bounds.w, bounds.h}; }
+
     /**
      * @brief 设置控件位置
      * @param x 新的 X 坐标
      * @param y 新的 Y 坐标
      */
     void setPosition(int x, int y) {
+        if (bounds.x == x && bounds.y == y) return;
+        invalidate(); // 旧位置
         bounds.x = x;
         bounds.y = y;
+        updateWorldOrigin();
+        invalidate(); // 新位置
+    }
+
+    /**
+     * @brief 设置控件位置，不标记重绘
+     * 供容器在自身的 draw() 中摆放由它绘制的子项 (如 List 复用的行控件)：新旧位置都在正在重绘的区域内，
+     * 用 setPosition() 会让下一帧再重绘一次 (宽度为 0 的控件还会使整屏失效)。
+     */
+    void placeAt(int x, int y) {
+        if (bounds.x == x && bounds.y == y) return;
+        bounds.x = x;
+        bounds.y = y;
+        updateWorldOrigin();
     }
 
     /**
@@ -79,10 +145,32 @@ public:
      * @param h 高度
      */
     void setSize(int w, int h) {
+        if (bounds.w == w && bounds.h == h) return;
+        invalidate();
         bounds.w = w;
         bounds.h = h;
+        invalidate();
     }
 
+    /**
+     * @brief 标记控件区域需要重绘
+     * 控件的动画状态或外观发生变化时调用，Application 只会重绘并刷新这些区域。
+     * 边界为空的控件 (如自适应宽度的 Label) 无法确定范围，会使整屏失效。
+     */
+    void invalidate();
+
+    /**
+     * @brief 标记控件内的指定区域需要重绘
+     * @param area 与 bounds 同一坐标系 (父控件坐标，根控件即世界坐标) 的矩形
+     */
+    void invalidate(const Rect& area);
+
+    /**
+     * @brief 以 Animator 回调的形式调用 invalidate()
+     * 用作补间的 onChange 回调，user 参数为控件指针。
+     */
+    static void invalidateCallback(void* widget) { static_cast<Widget*>(widget)->invalidate(); }
+
     /**
      * @brief 检查控件是否可交互
      * 用于列表选择逻辑：只有可交互的控件才能被选中
@@ -95,10 +183,23 @@ public:
     virtual void click() {}
 
     /**
-     * @brief 获取控件内容的字符串表示
-     * 用于列表宽度自适应计算
+     * @brief 处理输入事件
+     * Application 在 update() 开始时把队列中的事件依次交给根控件 (后添加的优先)，
+     * 直到某个控件返回 true。
+     * @return 事件是否已被处理
+     */
+    virtual bool handleEvent(const InputEvent& e) { (void)e; return false; }
+
+    /**
+     * @brief 获取控件显示的文本
+     * 用于列表宽度自适应计算。返回的指针在文本被修改或控件销毁前有效，读取时不会分配内存。
+     */
+    virtual const char* getText() const { return ""; }
+
+    /**
+     * @brief 获取控件内容的字符串表示 (复制一份 getText())
      */
-    virtual std::string toString() const { return ""; }
+    virtual std::string toString() const { return getText(); }
 };
 
 /**
@@ -106,16 +207,17 @@ public:
  * 用于显示单行文本。
  */
 class Label : public Widget {
-    std::string text;
+    TextValue text;
     bool hasArrow; // 是否显示二级菜单箭头
 
 public:
     // w 默认为 0 (自适应宽度)。如果设置了 w (如 100)，则箭头会画在最右边
-    Label(int x, int y, const std::string& text, bool hasArrow = false, int w = 0)
+    // text 传入 StaticText("...") 时只引用不复制
+    Label(int x, int y, const TextValue& text, bool hasArrow = false, int w = 0)
         : Widget(x, y, w, 0), text(text), hasArrow(hasArrow) {}
 
     void draw(Graphics& g) override;
-    std::string toString() const override { return text; }
+    const char* getText() const override { return text.c_str(); }
 
     // 如果有箭头，通常意味着这是一个可点击进入的菜单项
     bool isInteractive() const override { return hasArrow; }
@@ -127,20 +229,23 @@ public:
  */
 class Switch : public Widget {
 private:
-    std::string label;
+    TextValue label;
     bool isOn;
 
     // 动画状态
-    float knobX;        // 当前滑块位置 (0.0 ~ 1.0)
-    float targetKnobX;  // 目标位置 (0.0 或 1.0)
+    Scalar knobX;        // 当前滑块位置 (0.0 ~ 1.0)
+    Scalar targetKnobX;  // 目标位置 (0.0 或 1.0)
+    uint16_t duration;   // 滑块动画时长 (毫秒)
 
 public:
-    Switch(int x, int y, int w, int h, const std::string& label, bool initial = false)
-        : Widget(x, y, w, h), label(label), isOn(initial), knobX(initial ? 1.0f : 0.0f), targetKnobX(initial ? 1.0f : 0.0f) {}
+    Switch(int x, int y, int w, int h, const TextValue& label, bool initial = false)
+        : Widget(x, y, w, h), label(label), isOn(initial), knobX(initial ? 1 : 0), targetKnobX(initial ? 1 : 0),
+          duration(150) {}
+    ~Switch();
 
-    void update() override;
     void draw(Graphics& g) override;
-    std::string toString() const override { return label; }
+    bool isAnimating() const override { return knobX != targetKnobX; }
+    const char* getText() const override { return label.c_str(); }
 
     bool isInteractive() const override { return true; }
     void click() override { toggle(); }
@@ -149,6 +254,12 @@ public:
     void toggle();
     void setState(bool s);
     bool getState() const { return isOn; }
+
+    /**
+     * @brief 设置滑块动画时长
+     * @param ms 时长 (毫秒)
+     */
+    void setDuration(uint16_t ms) { duration = ms; }
 };
 
 /**
@@ -157,38 +268,47 @@ public:
  */
 class ProgressBar : public Widget {
 private:
-    std::string label;
-    float value;        // 当前显示的平滑值 (0.0 ~ 1.0)
-    float targetValue;  // 目标值
-    bool twoLineMode;   // 是否分两行显示
-    float smoothing;    // 平滑系数 (0.0 ~ 1.0, 越小越平滑)
+    TextValue label;
+    Scalar value;        // 当前显示的平滑值 (0.0 ~ 1.0)
+    Scalar targetValue;  // 目标值
+    bool twoLineMode;    // 是否分两行显示
+    uint16_t duration;   // 数值变化的过渡时长 (毫秒)
 
 public:
     /**
      * @param twoLineMode 如果为 true，文字在第一行，进度条在第二行
      */
-    ProgressBar(int x, int y, int w, int h, const std::string& label, float initial = 0.0f, bool twoLineMode = false)
-        : Widget(x, y, w, h), label(label), value(initial), targetValue(initial), twoLineMode(twoLineMode), smoothing(0.2f) {}
+    ProgressBar(int x, int y, int w, int h, const TextValue& label, float initial = 0.0f, bool twoLineMode = false)
+        : Widget(x, y, w, h), label(label), value(initial), targetValue(initial), twoLineMode(twoLineMode),
+          duration(300) {}
+    ~ProgressBar();
 
-    void update() override;
     void draw(Graphics& g) override;
-    std::string toString() const override { return label; }
+    bool isAnimating() const override { return value != targetValue; }
+    const char* getText() const override { return label.c_str(); }
 
     // 进度条通常是只读展示，不可交互
     bool isInteractive() const override { return false; }
 
-    void setValue(float v) {
-        if (v < 0.0f) v = 0.0f;
-        if (v > 1.0f) v = 1.0f;
-        targetValue = v; // 仅设置目标值，实际值在 update 中平滑过渡
-    }
-    float getValue() const { return targetValue; }
+    /**
+     * @brief 设置目标值 (0.0 ~ 1.0)
+     * 显示值会在 setDuration() 指定的时长内平滑过渡到目标值
+     */
+    void setValue(float v);
+    float getValue() const { return scalarToFloat(targetValue); }
 
     /**
-     * @brief 设置平滑系数
+     * @brief 设置数值过渡时长
+     * @param ms 时长 (毫秒)
+     */
+    void setDuration(uint16_t ms) { duration = ms; }
+
+    /**
+     * @brief 设置平滑系数 (兼容旧接口)
+     * 按指数平滑走完约 95% 距离所需的时间换算为过渡时长。
      * @param s 0.1(慢) ~ 1.0(快)
      */
-    void setSmoothing(float s) { smoothing = s; }
+    void setSmoothing(float s);
 };
 
 /**
@@ -231,26 +351,98 @@ public:
     void draw(Graphics& g) override;
 };
 
+/**
+ * @brief 容器控件
+ * 本身只绘制可选的边框，用 addChild() 组合子控件 (坐标相对于面板左上角)。
+ * 面板移出屏幕时其中的所有子控件一起被跳过。
+ */
+class Panel : public Widget {
+private:
+    bool border;
+
+public:
+    Panel(int x, int y, int w, int h, bool border = false) : Widget(x, y, w, h), border(border) {}
+    void draw(Graphics& g) override;
+};
+
 /**
  * @brief 日志终端控件
  * 用于显示滚动的日志文本
+ *
+ * 日志行保存在构造时一次性分配的字符区 (arena) 中，行描述符组成固定容量的环形缓冲区，
+ * 记录日志不会分配或释放堆内存。行数超过 maxLines 或字符区写满时丢弃最旧的行。
+ *
+ * log()/logf()/clear() 是生产者接口，可以在另一个任务或中断里调用 (同一时刻只能有一个生产者)；
+ * 绘制端通过序号 (seqlock) 检查读到的是否是一致的数据，读的过程中被改写则下一帧重绘。
  */
 class Logger : public Widget {
 private:
-    std::vector<std::string> lines;
+    struct Line {
+        uint32_t pos;    ///< 行首在写入流中的位置 (单调递增，用于判断是否已被覆盖)
+        uint16_t offset; ///< 行首在字符区中的偏移
+        uint16_t length;
+    };
+
+    std::vector<char> arena;
+    std::vector<Line> lines;   ///< maxLines 个槽位，按 head/tail 环形使用
     int maxLines;
     int lineHeight;
     bool autoScroll;
 
+    // 以下状态只由生产者修改，绘制端在 seq 的保护下读取
+    uint32_t head;             ///< 已写入的行数 (单调递增)
+    uint32_t tail;             ///< 最旧的有效行
+    uint32_t written;          ///< 写入流的总字节数 (含换行时跳过的尾部)
+    size_t cursor;             ///< 下一次写入在字符区中的偏移
+    std::atomic<uint32_t> seq; ///< 生产者修改期间为奇数
+    uint32_t drawnSeq;         ///< 上一次完整绘制时的 seq
+
+    /**
+     * @brief 为 size 字节的新行选定起始偏移，并丢弃会被覆盖的旧行
+     */
+    size_t place(size_t size);
+
+    /**
+     * @brief 提交 [start, start + length) 为新的一行
+     */
+    void commit(size_t start, size_t length);
+
+    // 生产者修改的开始与结束 (seq 变为奇数/偶数)
+    void beginWrite();
+    void endWrite();
+
 public:
-    Logger(int x, int y, int w, int h, int maxLines = 10)
-        : Widget(x, y, w, h), maxLines(maxLines), lineHeight(12), autoScroll(true) {}
+    /**
+     * @param maxLines 最多保留的行数
+     * @param arenaSize 字符区字节数，0 表示按每行 32 字节分配
+     */
+    Logger(int x, int y, int w, int h, int maxLines = 10, size_t arenaSize = 0);
 
-    void log(const std::string& msg);
-    void draw(Graphics& g) override;
+    /**
+     * @brief 追加一行日志 (不分配内存，可在中断中调用)
+     * 超过字符区大小的部分被截断。
+     */
+    void log(const char* msg);
+    void log(const std::string& msg) { log(msg.c_str()); }
+
+    /**
+     * @brief 以 printf 格式追加一行日志，直接格式化到字符区中
+     * 依赖 C 库的 vsnprintf，通常不适合在中断中调用。
+     */
+    void logf(const char* fmt, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 2, 3)))
+#endif
+        ;
+    void vlogf(const char* fmt, va_list args);
 
-    // 清空日志
-    void clear() { lines.clear(); }
+    /**
+     * @brief 清空日志 (同样属于生产者操作)
+     */
+    void clear();
+
+    void update() override;
+    void draw(Graphics& g) override;
 };
 
 /**
@@ -259,8 +451,8 @@ public:
 class MatrixRain : public Widget {
 private:
     struct Column {
-        float y;       // 当前下落高度
-        float speed;   // 下落速度
+        Scalar y;      // 当前下落高度
+        Scalar speed;  // 下落速度
         char content;  // 当前显示的字符（头）
         int length;    // 雨滴长度
     };
@@ -271,6 +463,8 @@ public:
     MatrixRain(int x, int y, int w, int h);
     void update() override;
     void draw(Graphics& g) override;
+    bool isAnimating() const override { return visible; }
+    bool isDecorative() const override { return true; }
 };
 
 } // namespace Hydrogen
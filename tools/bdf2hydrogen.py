@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+"""
+bdf2hydrogen.py - 把 BDF 位图字体转换为 HydrogenUI 原生字体 (Hydrogen::Font)
+
+生成一个头文件，包含升序码位表、字形度量表与 XBM 布局的 1bpp 位图，
+可直接 #include 后通过 App.getGraphics()->setFont(&name) 使用。
+
+用法:
+    python3 tools/bdf2hydrogen.py wenquanyi_12pt.bdf -n font_wqy12 -o font_wqy12.h \\
+        --range 32-126 --text menu_strings.txt
+
+    --range  按码位区间筛选，逗号分隔，支持十六进制 (如 32-126,0x4E00-0x9FA5)
+    --text   只保留这些 UTF-8 文本文件中出现过的字符 (用于裁剪中文字库)
+    两者都不指定时转换全部字形；同时指定时取并集。
+"""
+import argparse
+import sys
+
+
+def parse_ranges(spec):
+    ranges = []
+    for part in spec.split(","):
+        part = part.strip()
+        if not part:
+            continue
+        if "-" in part:
+            lo, hi = part.split("-", 1)
+            ranges.append((int(lo, 0), int(hi, 0)))
+        else:
+            v = int(part, 0)
+            ranges.append((v, v))
+    return ranges
+
+
+def parse_bdf(path):
+    """返回 (ascent, descent, glyphs)，glyphs 为 {码位: (advance, w, h, xoff, yoff, rows)}。
+    rows 为每行像素的整数，最高位对应最左侧像素。"""
+    ascent = descent = None
+    glyphs = {}
+    with open(path, "r", encoding="latin-1") as f:
+        lines = iter(f.read().splitlines())
+    for line in lines:
+        tok = line.split()
+        if not tok:
+            continue
+        if tok[0] == "FONT_ASCENT":
+            ascent = int(tok[1])
+        elif tok[0] == "FONT_DESCENT":
+            descent = int(tok[1])
+        elif tok[0] == "STARTCHAR":
+            code = -1
+            advance = 0
+            bbx = (0, 0, 0, 0)
+            rows = []
+            for line in lines:
+                tok = line.split()
+                if not tok:
+                    continue
+                if tok[0] == "ENCODING":
+                    code = int(tok[1])
+                elif tok[0] == "DWIDTH":
+                    advance = int(tok[1])
+                elif tok[0] == "BBX":
+                    bbx = tuple(int(v) for v in tok[1:5])
+                elif tok[0] == "BITMAP":
+                    w, h = bbx[0], bbx[1]
+                    for _ in range(h):
+                        hexrow = next(lines).strip()
+                        v = int(hexrow, 16) if hexrow else 0
+                        # 行数据按字节补齐，移掉补齐位后只剩 w 个像素
+                        pad = len(hexrow) * 4 - w
+                        rows.append(v >> pad if pad >= 0 else v << -pad)
+                elif tok[0] == "ENDCHAR":
+                    break
+            if 0 <= code <= 0xFFFF:
+                glyphs[code] = (advance, bbx[0], bbx[1], bbx[2], bbx[3], rows)
+    return ascent, descent, glyphs
+
+
+def trim(w, h, xoff, top, rows):
+    """去掉四周的空白行列，返回新的 (w, h, xoff, top, rows)"""
+    if not any(rows):
+        return 0, 0, 0, 0, []
+    first = next(i for i, r in enumerate(rows) if r)
+    last = max(i for i, r in enumerate(rows) if r)
+    rows = rows[first:last + 1]
+    top += first
+    mask = 0
+    for r in rows:
+        mask |= r
+    # 最高位为最左侧像素 (位 w-1)
+    left = w - mask.bit_length()
+    right = (mask & -mask).bit_length() - 1
+    nw = w - left - right
+    rows = [(r >> right) & ((1 << nw) - 1) for r in rows]
+    return nw, len(rows), xoff + left, top, rows
+
+
+def to_xbm(w, rows):
+    """转换为 XBM 布局：每行 (w+7)/8 字节，字节内低位在左"""
+    out = []
+    for r in rows:
+        row = [0] * ((w + 7) // 8)
+        for i in range(w):
+            if r & (1 << (w - 1 - i)):
+                row[i >> 3] |= 1 << (i & 7)
+        out.extend(row)
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("bdf", help="输入的 BDF 字体文件")
+    ap.add_argument("-n", "--name", required=True, help="生成的 Font 变量名")
+    ap.add_argument("-o", "--output", help="输出头文件 (默认输出到标准输出)")
+    ap.add_argument("--range", action="append", default=[], help="码位区间，如 32-126,0x4E00-0x9FA5")
+    ap.add_argument("--text", action="append", default=[], help="只保留该 UTF-8 文件中出现的字符")
+    ap.add_argument("--fallback", default="?", help="缺字时显示的字符 (空字符串表示跳过缺字)")
+    ap.add_argument("--no-trim", action="store_true", help="保留 BDF 中的原始包围盒")
+    ap.add_argument("--include", default="HydrogenUI.h", help="生成文件 #include 的头文件")
+    args = ap.parse_args()
+
+    ascent, descent, glyphs = parse_bdf(args.bdf)
+
+    wanted = None
+    if args.range or args.text:
+        wanted = set()
+        for spec in args.range:
+            for lo, hi in parse_ranges(spec):
+                wanted.update(range(lo, hi + 1))
+        for path in args.text:
+            with open(path, "r", encoding="utf-8") as f:
+                wanted.update(ord(c) for c in f.read() if ord(c) <= 0xFFFF)
+        fb = ord(args.fallback) if args.fallback else None
+        if fb is not None:
+            wanted.add(fb)
+
+    codes = sorted(c for c in glyphs if wanted is None or c in wanted)
+    if not codes:
+        sys.exit("error: no glyphs selected")
+    if wanted is not None:
+        missing = sorted(c for c in wanted if c not in glyphs and c >= 32)
+        if missing:
+            sys.stderr.write("warning: %d requested characters are not in the font\n" % len(missing))
+
+    entries = []
+    bitmap = []
+    max_ascent = max_descent = 0
+    for c in codes:
+        advance, w, h, xoff, yoff, rows = glyphs[c]
+        top = -(yoff + h)  # 位图顶边相对基线，向下为正
+        if not args.no_trim:
+            w, h, xoff, top, rows = trim(w, h, xoff, top, rows)
+        if w > 255 or h > 255 or advance > 255 or not -128 <= xoff <= 127 or not -128 <= top <= 127:
+            sys.exit("error: glyph U+%04X does not fit the compact format" % c)
+        if h:
+            max_ascent = max(max_ascent, -top)
+            max_descent = max(max_descent, top + h)
+        entries.append((c, len(bitmap), w, h, advance, xoff, top))
+        bitmap.extend(to_xbm(w, rows))
+
+    if ascent is None:
+        ascent = max_ascent
+    if descent is None:
+        descent = max_descent
+    fallback = ord(args.fallback) if args.fallback and ord(args.fallback) in glyphs else 0
+
+    n = args.name
+    out = []
+    out.append("// Generated by tools/bdf2hydrogen.py from %s" % args.bdf.replace("\\", "/").split("/")[-1])
+    out.append("// %d glyphs, %d bitmap bytes" % (len(entries), len(bitmap)))
+    out.append("#pragma once")
+    out.append('#include "%s"' % args.include)
+    out.append("")
+    out.append("static const uint16_t %s_codepoints[] = {" % n)
+    for i in range(0, len(entries), 12):
+        out.append("    " + ", ".join("0x%04X" % e[0] for e in entries[i:i + 12]) + ",")
+    out.append("};")
+    out.append("")
+    out.append("static const Hydrogen::FontGlyph %s_glyphs[] = {" % n)
+    for c, off, w, h, adv, x, y in entries:
+        out.append("    {%d, %d, %d, %d, %d, %d}, // U+%04X" % (off, w, h, adv, x, y, c))
+    out.append("};")
+    out.append("")
+    out.append("static const uint8_t %s_bitmaps[] = {" % n)
+    for i in range(0, len(bitmap), 16):
+        out.append("    " + ", ".join("0x%02X" % b for b in bitmap[i:i + 16]) + ",")
+    if not bitmap:
+        out.append("    0x00,")
+    out.append("};")
+    out.append("")
+    out.append("static const Hydrogen::Font %s = {" % n)
+    out.append("    %s_codepoints, %s_glyphs, %s_bitmaps, %d, %d, %d, 0x%04X" %
+               (n, n, n, len(entries), ascent, descent, fallback))
+    out.append("};")
+    text = "\n".join(out) + "\n"
+
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main()